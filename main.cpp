@@ -1,6 +1,3 @@
-
-
-
 #include <iostream>
 #include "src/slnode.hpp"
 #include "src/skiplist.hpp"
@@ -10,23 +7,23 @@ using namespace std;
 
 
 int main() {
-    skiplist<double> sk(0.9);
+    skiplist<double, double> sk(0.9);
 
-    sk.insert(5);
+    sk.insert(5.0, 5.0);
 
     cout << "first = " << sk.back() << endl;
-    sk.insert(6);
+    sk.insert(6.0, 6.0);
     cout << "first = " << sk.back() << endl;
-    sk.insert(7);
+    sk.insert(7.0, 7.0);
     cout << "first = " << sk.back() << endl;
-    sk.insert(8);
+    sk.insert(8.0, 8.0);
     cout << "first = " << sk.back() << endl;
-    sk.insert(1);
-    sk.insert(3);
-    sk.insert(1);
+    sk.insert(1.0, 1.0);
+    sk.insert(3.0, 3.0);
+    sk.insert(1.0, 1.0);
     cout << "first = " << sk.back() << endl;
-    sk.insert(0);
-    sk.insert(9);
+    sk.insert(0.0, 0.0);
+    sk.insert(9.0, 9.0);
     
     cout << "first = " << sk.back() << endl;
 
@@ -36,5 +33,14 @@ int main() {
 
     cout << "size = " << sk.size() << endl;
 
+    skiplist<int, int> big;
+    for(int i=0; i < 100000; i++) {
+        big.insert(i, i % 7);
+    }
+    long sum = big.parallel_reduce(10, 90000, 0L, 
+        [](long acc, const skiplist<int, int>::value_type& kv) { return acc + *kv.second; },
+        [](long a, long b) { return a + b; }, 8);
+    cout << "parallel sum = " << sum << endl;
+
     return 0;
-}
\ No newline at end of file
+}
@@ -0,0 +1,429 @@
+#ifndef COMPRESSED_SKIPLIST_H
+#define COMPRESSED_SKIPLIST_H
+
+#include <functional>
+#include <vector>
+#include <array>
+#include <new>
+#include <random>
+#include <chrono>
+#include <utility>
+#include <iterator>
+#include <cstddef>
+#include "skiplist_exceptions.hpp"
+#include "skiplist_codecs.hpp"
+
+
+// Skiplist whose level 0 nodes store their key encoded against the previous
+// key, front coded for std::string by default. Towers of the upper levels
+// keep full keys, so a search descends them as in skiplist and only decodes
+// the run of level 0 nodes following the last tower it passes. Values are
+// held in the level 0 nodes. Towers being the costly part, p defaults to 0.25.
+template<class K, class V, class Codec=typename default_codec<K>::type, class Compare=std::less<K>, typename TRandom=std::default_random_engine, int MaxLevel=10>
+class compressed_skiplist {
+    struct tower;
+
+    struct entry {
+        entry* next;
+        tower* anchor;
+        typename Codec::encoded_type code;
+        V value;
+    };
+
+    // full key of an entry, linked on height express levels through the
+    // links allocated right after it, so that a hop reads a single block;
+    // the first entry and the entries the codec cannot encode have one of
+    // height 0
+    struct tower {
+        K key;
+        entry* bottom;
+        int height;
+
+        tower** next() { return reinterpret_cast<tower**>(this + 1); }
+    };
+
+    // last tower before the key on each express level, only writers need it
+    typedef std::array<tower*, MaxLevel - 1> path;
+
+    struct position {
+        entry* prev;
+        K prev_key;
+        entry* cur;
+        K cur_key;
+    };
+
+    std::vector<tower*> head;
+    entry* first;
+    double prob;
+    size_t nb;
+    size_t towers;
+    size_t links;
+    size_t code_bytes;
+    TRandom generator;
+
+    static void key_after(const entry* e, K& key) {
+        if(e->anchor) key = e->anchor->key;
+        else Codec::decode(key, e->code);
+    }
+    int random_height();
+    tower* make_tower(const K& key, entry* e, int height);
+    void drop_tower(tower* t);
+    void encode_entry(entry* e, const K& prev, const K& key);
+    void anchor_entry(entry* e, const K& key);
+    position search(const K& k, path* update=nullptr) const;
+    entry* insert_at(const position& pos, const path& update, const K& k, const V& v);
+
+public:
+    template <class R> class basic_iterator;
+    typedef basic_iterator<V> iterator;
+    typedef basic_iterator<const V> const_iterator;
+
+    compressed_skiplist(double p=0.25);
+    compressed_skiplist(const compressed_skiplist<K, V, Codec, Compare, TRandom, MaxLevel>& sk);
+    compressed_skiplist<K, V, Codec, Compare, TRandom, MaxLevel>& operator=(const compressed_skiplist<K, V, Codec, Compare, TRandom, MaxLevel>& sk);
+
+    ~compressed_skiplist() { clear(); }
+    size_t size() const { return nb; }
+    bool empty() const { return nb==0; }
+    double get_prob() const { return prob; }
+    void clear();
+    void swap(compressed_skiplist& sk);
+    size_t memory_usage() const;
+
+    bool insert(const K& k, const V& v);
+    size_t erase(const K& k);
+    bool exists(const K& k) const;
+    const K& front() const;
+
+    V& operator[](const K& k);
+    const V& at(const K& k) const;
+    V& at(const K& k);
+
+    iterator begin() { return first? iterator(first, first->anchor->key) : end(); }
+    iterator end() { return iterator(); }
+    const_iterator cbegin() const { return first? const_iterator(first, first->anchor->key) : cend(); }
+    const_iterator cend() const { return const_iterator(); }
+
+    iterator find(const K& k);
+    const_iterator find(const K& k) const;
+    iterator lower_bound(const K& k);
+    const_iterator lower_bound(const K& k) const;
+
+    // forward iterator decoding the keys as it goes, it hands out a reference
+    // to its own decoded copy of the key
+    template <class R>
+    class basic_iterator {
+    public:
+        typedef std::forward_iterator_tag iterator_category;
+        typedef std::pair<const K&, R&> value_type;
+        typedef std::pair<const K&, R&> reference;
+        typedef std::ptrdiff_t difference_type;
+
+        basic_iterator(entry* e=nullptr, const K& key=K()): current(e), key(key) {}
+
+        reference operator*() const { return reference(key, current->value); }
+        basic_iterator& operator++() {
+            current = current->next;
+            if(current) key_after(current, key);
+            return *this;
+        }
+        basic_iterator operator++(int) {
+            basic_iterator tmp = *this;
+            ++(*this);
+            return tmp;
+        }
+
+        friend bool operator== (const basic_iterator& a, const basic_iterator& b) { return a.current==b.current; }
+        friend bool operator!= (const basic_iterator& a, const basic_iterator& b) { return a.current!=b.current; }
+    private:
+        entry* current;
+        K key;
+    };
+};
+
+
+template<class K, class V, class Codec, class Compare, typename TRandom, int MaxLevel>
+compressed_skiplist<K, V, Codec, Compare, TRandom, MaxLevel>::compressed_skiplist(double p): head(MaxLevel - 1, nullptr), first(nullptr), prob(p), nb(0),
+        towers(0), links(0), code_bytes(0), generator(std::chrono::system_clock::now().time_since_epoch().count()) {}
+
+template<class K, class V, class Codec, class Compare, typename TRandom, int MaxLevel>
+compressed_skiplist<K, V, Codec, Compare, TRandom, MaxLevel>::compressed_skiplist(const compressed_skiplist<K, V, Codec, Compare, TRandom, MaxLevel>& sk): compressed_skiplist(sk.prob) {
+    for(auto it=sk.cbegin(); it != sk.cend(); ++it) {
+        insert((*it).first, (*it).second);
+    }
+}
+
+template<class K, class V, class Codec, class Compare, typename TRandom, int MaxLevel>
+compressed_skiplist<K, V, Codec, Compare, TRandom, MaxLevel>& compressed_skiplist<K, V, Codec, Compare, TRandom, MaxLevel>::operator=(const compressed_skiplist<K, V, Codec, Compare, TRandom, MaxLevel>& sk) {
+    if(this != &sk) {
+        clear();
+        prob = sk.prob;
+        for(auto it=sk.cbegin(); it != sk.cend(); ++it) {
+            insert((*it).first, (*it).second);
+        }
+    }
+    return *this;
+}
+
+template<class K, class V, class Codec, class Compare, typename TRandom, int MaxLevel>
+void compressed_skiplist<K, V, Codec, Compare, TRandom, MaxLevel>::clear() {
+    entry* e = first;
+    while(e) {
+        entry* tmp = e->next;
+        if(e->anchor) drop_tower(e->anchor);
+        delete e;
+        e = tmp;
+    }
+    for(int i=0; i < head.size(); i++) {
+        head[i] = nullptr;
+    }
+    first = nullptr;
+    nb = 0;
+    code_bytes = 0;
+}
+
+template<class K, class V, class Codec, class Compare, typename TRandom, int MaxLevel>
+void compressed_skiplist<K, V, Codec, Compare, TRandom, MaxLevel>::swap(compressed_skiplist<K, V, Codec, Compare, TRandom, MaxLevel>& sk) {
+    std::swap(this->first, sk.first);
+    std::swap(this->prob, sk.prob);
+    std::swap(this->nb, sk.nb);
+    std::swap(this->towers, sk.towers);
+    std::swap(this->links, sk.links);
+    std::swap(this->code_bytes, sk.code_bytes);
+    std::swap(this->generator, sk.generator);
+    this->head.swap(sk.head);
+}
+
+template<class K, class V, class Codec, class Compare, typename TRandom, int MaxLevel>
+size_t compressed_skiplist<K, V, Codec, Compare, TRandom, MaxLevel>::memory_usage() const {
+    return nb * sizeof(entry) + towers * sizeof(tower) + links * sizeof(tower*) + code_bytes;
+}
+
+template<class K, class V, class Codec, class Compare, typename TRandom, int MaxLevel>
+int compressed_skiplist<K, V, Codec, Compare, TRandom, MaxLevel>::random_height() {
+    int h = 0;
+    while(h < MaxLevel - 1 && generator() < (generator.max() + generator.min()) * this->prob) {
+        h++;
+    }
+    return h;
+}
+
+template<class K, class V, class Codec, class Compare, typename TRandom, int MaxLevel>
+typename compressed_skiplist<K, V, Codec, Compare, TRandom, MaxLevel>::tower* compressed_skiplist<K, V, Codec, Compare, TRandom, MaxLevel>::make_tower(const K& key, entry* e, int height) {
+    void* raw = ::operator new(sizeof(tower) + height * sizeof(tower*));
+    tower* t;
+    try {
+        t = new(raw) tower{key, e, height};
+    } catch(...) {
+        ::operator delete(raw);
+        throw;
+    }
+    for(int i=0; i < height; i++) {
+        new(t->next() + i) tower*(nullptr);
+    }
+    towers++;
+    links += height;
+    return t;
+}
+
+template<class K, class V, class Codec, class Compare, typename TRandom, int MaxLevel>
+void compressed_skiplist<K, V, Codec, Compare, TRandom, MaxLevel>::drop_tower(tower* t) {
+    towers--;
+    links -= t->height;
+    t->~tower();
+    ::operator delete(t);
+}
+
+template<class K, class V, class Codec, class Compare, typename TRandom, int MaxLevel>
+void compressed_skiplist<K, V, Codec, Compare, TRandom, MaxLevel>::encode_entry(entry* e, const K& prev, const K& key) {
+    // entries reaching the express levels keep their full key anyway
+    if(e->anchor && e->anchor->height > 0) return;
+
+    typename Codec::encoded_type code;
+    try {
+        code = Codec::encode(prev, key);
+    } catch(SkiplistException&) {
+        anchor_entry(e, key);
+        return;
+    }
+    code_bytes -= Codec::heap_size(e->code);
+    e->code = code;
+    code_bytes += Codec::heap_size(e->code);
+    if(e->anchor) {
+        drop_tower(e->anchor);
+        e->anchor = nullptr;
+    }
+}
+
+template<class K, class V, class Codec, class Compare, typename TRandom, int MaxLevel>
+void compressed_skiplist<K, V, Codec, Compare, TRandom, MaxLevel>::anchor_entry(entry* e, const K& key) {
+    if(e->anchor) return;
+    code_bytes -= Codec::heap_size(e->code);
+    e->code = typename Codec::encoded_type();
+    e->anchor = make_tower(key, e, 0);
+}
+
+template<class K, class V, class Codec, class Compare, typename TRandom, int MaxLevel>
+typename compressed_skiplist<K, V, Codec, Compare, TRandom, MaxLevel>::position compressed_skiplist<K, V, Codec, Compare, TRandom, MaxLevel>::search(const K& k, path* update) const {
+    // cur is the first entry whose key is not less than k, prev the one before;
+    // for writers, which pass update, the last tower before k on each express
+    // level and the key of prev are kept as well
+    position pos;
+    pos.prev = nullptr;
+    pos.cur = first;
+
+    tower* t = nullptr;
+    for(int i=MaxLevel - 2; i >= 0; i--) {
+        tower* n = t? t->next()[i] : head[i];
+        while(n && Compare()(n->key, k)) {
+            t = n;
+            n = t->next()[i];
+        }
+        if(update) (*update)[i] = t;
+    }
+
+    if(t) {
+        pos.prev = t->bottom;
+        if(update) pos.prev_key = t->key;
+        pos.cur = t->bottom->next;
+        pos.cur_key = t->key;
+    }
+    if(pos.cur) key_after(pos.cur, pos.cur_key);
+
+    while(pos.cur && Compare()(pos.cur_key, k)) {
+        pos.prev = pos.cur;
+        if(update) pos.prev_key = pos.cur_key;
+        pos.cur = pos.cur->next;
+        if(pos.cur) key_after(pos.cur, pos.cur_key);
+    }
+    return pos;
+}
+
+template<class K, class V, class Codec, class Compare, typename TRandom, int MaxLevel>
+typename compressed_skiplist<K, V, Codec, Compare, TRandom, MaxLevel>::entry* compressed_skiplist<K, V, Codec, Compare, TRandom, MaxLevel>::insert_at(const position& pos, const path& update, const K& k, const V& v) {
+    // links a new entry for k between pos.prev and pos.cur
+    int h = random_height();
+    entry* e = new entry{pos.cur, nullptr, typename Codec::encoded_type(), v};
+    if(h > 0 || ! pos.prev) {
+        e->anchor = make_tower(k, e, h);
+        for(int i=0; i < h; i++) {
+            tower*& link = update[i]? update[i]->next()[i] : head[i];
+            e->anchor->next()[i] = link;
+            link = e->anchor;
+        }
+    } else {
+        encode_entry(e, pos.prev_key, k);
+    }
+
+    if(pos.prev) pos.prev->next = e;
+    else first = e;
+    if(pos.cur) encode_entry(pos.cur, k, pos.cur_key);
+    nb++;
+    return e;
+}
+
+template<class K, class V, class Codec, class Compare, typename TRandom, int MaxLevel>
+bool compressed_skiplist<K, V, Codec, Compare, TRandom, MaxLevel>::insert(const K& k, const V& v) {
+    path update;
+    position pos = search(k, &update);
+    if(pos.cur && pos.cur_key == k) return false;
+    insert_at(pos, update, k, v);
+    return true;
+}
+
+template<class K, class V, class Codec, class Compare, typename TRandom, int MaxLevel>
+size_t compressed_skiplist<K, V, Codec, Compare, TRandom, MaxLevel>::erase(const K& k) {
+    path update;
+    position pos = search(k, &update);
+    if(! pos.cur || ! (pos.cur_key == k)) return 0;
+
+    entry* e = pos.cur;
+    if(e->next) {
+        K key = pos.cur_key;
+        key_after(e->next, key);
+        if(pos.prev) encode_entry(e->next, pos.prev_key, key);
+        else anchor_entry(e->next, key);
+    }
+
+    if(pos.prev) pos.prev->next = e->next;
+    else first = e->next;
+    if(e->anchor) {
+        for(int i=0; i < e->anchor->height; i++) {
+            tower*& link = update[i]? update[i]->next()[i] : head[i];
+            link = e->anchor->next()[i];
+        }
+        drop_tower(e->anchor);
+    }
+    code_bytes -= Codec::heap_size(e->code);
+    delete e;
+    nb--;
+    return 1;
+}
+
+template<class K, class V, class Codec, class Compare, typename TRandom, int MaxLevel>
+bool compressed_skiplist<K, V, Codec, Compare, TRandom, MaxLevel>::exists(const K& k) const {
+    position pos = search(k);
+    return pos.cur && pos.cur_key == k;
+}
+
+template<class K, class V, class Codec, class Compare, typename TRandom, int MaxLevel>
+const K& compressed_skiplist<K, V, Codec, Compare, TRandom, MaxLevel>::front() const {
+    if(empty()) throw SkiplistException("Calling front method on an empty skiplist");
+    return first->anchor->key;
+}
+
+template<class K, class V, class Codec, class Compare, typename TRandom, int MaxLevel>
+V& compressed_skiplist<K, V, Codec, Compare, TRandom, MaxLevel>::operator[](const K& k) {
+    path update;
+    position pos = search(k, &update);
+    if(pos.cur && pos.cur_key == k) return pos.cur->value;
+    return insert_at(pos, update, k, V())->value;
+}
+
+template<class K, class V, class Codec, class Compare, typename TRandom, int MaxLevel>
+const V& compressed_skiplist<K, V, Codec, Compare, TRandom, MaxLevel>::at(const K& k) const {
+    position pos = search(k);
+    if(! pos.cur || ! (pos.cur_key == k)) {
+        throw SkiplistException("Key doesn't exist in skiplist");
+    } else {
+        return pos.cur->value;
+    }
+}
+
+template<class K, class V, class Codec, class Compare, typename TRandom, int MaxLevel>
+V& compressed_skiplist<K, V, Codec, Compare, TRandom, MaxLevel>::at(const K& k) {
+    position pos = search(k);
+    if(! pos.cur || ! (pos.cur_key == k)) {
+        throw SkiplistException("Key doesn't exist in skiplist");
+    } else {
+        return pos.cur->value;
+    }
+}
+
+template<class K, class V, class Codec, class Compare, typename TRandom, int MaxLevel>
+typename compressed_skiplist<K, V, Codec, Compare, TRandom, MaxLevel>::iterator compressed_skiplist<K, V, Codec, Compare, TRandom, MaxLevel>::find(const K& k) {
+    position pos = search(k);
+    if(! pos.cur || ! (pos.cur_key == k)) return end();
+    return iterator(pos.cur, pos.cur_key);
+}
+
+template<class K, class V, class Codec, class Compare, typename TRandom, int MaxLevel>
+typename compressed_skiplist<K, V, Codec, Compare, TRandom, MaxLevel>::const_iterator compressed_skiplist<K, V, Codec, Compare, TRandom, MaxLevel>::find(const K& k) const {
+    position pos = search(k);
+    if(! pos.cur || ! (pos.cur_key == k)) return cend();
+    return const_iterator(pos.cur, pos.cur_key);
+}
+
+template<class K, class V, class Codec, class Compare, typename TRandom, int MaxLevel>
+typename compressed_skiplist<K, V, Codec, Compare, TRandom, MaxLevel>::iterator compressed_skiplist<K, V, Codec, Compare, TRandom, MaxLevel>::lower_bound(const K& k) {
+    position pos = search(k);
+    return pos.cur? iterator(pos.cur, pos.cur_key) : end();
+}
+
+template<class K, class V, class Codec, class Compare, typename TRandom, int MaxLevel>
+typename compressed_skiplist<K, V, Codec, Compare, TRandom, MaxLevel>::const_iterator compressed_skiplist<K, V, Codec, Compare, TRandom, MaxLevel>::lower_bound(const K& k) const {
+    position pos = search(k);
+    return pos.cur? const_iterator(pos.cur, pos.cur_key) : cend();
+}
+
+#endif // COMPRESSED_SKIPLIST_H
@@ -0,0 +1,243 @@
+#ifndef SHARDED_SKIPLIST_H
+#define SHARDED_SKIPLIST_H
+
+#include <functional>
+#include <vector>
+#include <memory>
+#include <mutex>
+#include <shared_mutex>
+#include <atomic>
+#include <thread>
+#include <algorithm>
+#include "skiplist.hpp"
+
+
+// Map partitioned by key range into several skiplists, each behind its own
+// reader-writer lock, so that writers on different shards run in parallel.
+// Shard i holds the keys in [bounds[i-1], bounds[i]). Every operation holds
+// the partition lock shared; a shard growing larger than skew times the
+// average is relieved under the exclusive lock by splicing its keys above
+// the average into a neighbour, so that the next move is skew - 1 averages
+// of inserts away.
+template<class K, class V, class Compare=std::less<K>, typename TRandom=std::default_random_engine, int MaxLevel=10>
+class sharded_skiplist {
+    typedef skiplist<K, V, Compare, TRandom, MaxLevel> shard_type;
+
+    std::vector<std::unique_ptr<shard_type>> shards;
+    mutable std::vector<std::shared_mutex> locks;
+    std::vector<K> bounds;
+    mutable std::shared_mutex partition;
+    std::atomic<size_t> nb;
+    double skew;
+    size_t min_size;
+
+    size_t shard_of(const K& k) const { return std::upper_bound(bounds.begin(), bounds.end(), k, Compare()) - bounds.begin(); }
+    bool skewed(size_t shard_size) const { return nb >= min_size && shard_size * shards.size() > skew * nb; }
+    K key_at(const shard_type& shard, size_t rank) const;
+    void relieve(size_t i);
+
+public:
+    sharded_skiplist(size_t n=std::thread::hardware_concurrency(), double p=0.5);
+    sharded_skiplist(const std::vector<K>& split_keys, double p=0.5);
+    sharded_skiplist(const sharded_skiplist&) = delete;
+    sharded_skiplist& operator=(const sharded_skiplist&) = delete;
+
+    size_t size() const { return nb; }
+    bool empty() const { return nb==0; }
+    size_t shard_count() const { return shards.size(); }
+    std::vector<size_t> shard_sizes() const;
+    void set_rebalance(double skew, size_t min_size) { this->skew=skew; this->min_size=min_size; }
+
+    bool insert(const K& k, const V& v);
+    size_t erase(const K& k);
+    bool exists(const K& k) const;
+    bool find(const K& k, V& v) const;
+    void clear();
+    void rebalance();
+
+    template <class Function> void for_each(Function fn) const;
+    template <class Function> void for_each(const K& lo, const K& hi, Function fn) const;
+};
+
+
+template<class K, class V, class Compare, typename TRandom, int MaxLevel>
+sharded_skiplist<K, V, Compare, TRandom, MaxLevel>::sharded_skiplist(size_t n, double p): locks(std::max<size_t>(n, 1)), nb(0), skew(1.5), min_size(1024) {
+    // bounds are found by the first rebalance, until then everything goes to shard 0
+    for(size_t i=0; i < locks.size(); i++) {
+        shards.emplace_back(new shard_type(p));
+    }
+}
+
+template<class K, class V, class Compare, typename TRandom, int MaxLevel>
+sharded_skiplist<K, V, Compare, TRandom, MaxLevel>::sharded_skiplist(const std::vector<K>& split_keys, double p): locks(split_keys.size() + 1), bounds(split_keys), nb(0), skew(1.5), min_size(1024) {
+    std::sort(bounds.begin(), bounds.end(), Compare());
+    for(size_t i=0; i < locks.size(); i++) {
+        shards.emplace_back(new shard_type(p));
+    }
+}
+
+template<class K, class V, class Compare, typename TRandom, int MaxLevel>
+std::vector<size_t> sharded_skiplist<K, V, Compare, TRandom, MaxLevel>::shard_sizes() const {
+    std::shared_lock<std::shared_mutex> guard(partition);
+    std::vector<size_t> ans;
+    for(size_t i=0; i < shards.size(); i++) {
+        std::shared_lock<std::shared_mutex> lock(locks[i]);
+        ans.push_back(shards[i]->size());
+    }
+    return ans;
+}
+
+template<class K, class V, class Compare, typename TRandom, int MaxLevel>
+bool sharded_skiplist<K, V, Compare, TRandom, MaxLevel>::insert(const K& k, const V& v) {
+    bool inserted, unbalanced;
+    {
+        std::shared_lock<std::shared_mutex> guard(partition);
+        size_t i = shard_of(k);
+        std::unique_lock<std::shared_mutex> lock(locks[i]);
+        inserted = shards[i]->insert(k, v).second;
+        if(inserted) nb++;
+        unbalanced = inserted && skewed(shards[i]->size());
+    }
+    if(unbalanced) {
+        // another writer may have relieved the shard while this one waited
+        std::unique_lock<std::shared_mutex> guard(partition);
+        relieve(shard_of(k));
+    }
+    return inserted;
+}
+
+template<class K, class V, class Compare, typename TRandom, int MaxLevel>
+size_t sharded_skiplist<K, V, Compare, TRandom, MaxLevel>::erase(const K& k) {
+    std::shared_lock<std::shared_mutex> guard(partition);
+    size_t i = shard_of(k);
+    std::unique_lock<std::shared_mutex> lock(locks[i]);
+    size_t ans = shards[i]->erase(k);
+    nb -= ans;
+    return ans;
+}
+
+template<class K, class V, class Compare, typename TRandom, int MaxLevel>
+bool sharded_skiplist<K, V, Compare, TRandom, MaxLevel>::exists(const K& k) const {
+    std::shared_lock<std::shared_mutex> guard(partition);
+    size_t i = shard_of(k);
+    std::shared_lock<std::shared_mutex> lock(locks[i]);
+    const shard_type& shard = *shards[i];
+    return shard.find(k) != shard.cend();
+}
+
+template<class K, class V, class Compare, typename TRandom, int MaxLevel>
+bool sharded_skiplist<K, V, Compare, TRandom, MaxLevel>::find(const K& k, V& v) const {
+    // the value is copied out since no reference may outlive the shard lock
+    std::shared_lock<std::shared_mutex> guard(partition);
+    size_t i = shard_of(k);
+    std::shared_lock<std::shared_mutex> lock(locks[i]);
+    const shard_type& shard = *shards[i];
+    auto it = shard.find(k);
+    if(it == shard.cend()) return false;
+    v = *(it->second);
+    return true;
+}
+
+template<class K, class V, class Compare, typename TRandom, int MaxLevel>
+void sharded_skiplist<K, V, Compare, TRandom, MaxLevel>::clear() {
+    std::unique_lock<std::shared_mutex> guard(partition);
+    for(size_t i=0; i < shards.size(); i++) {
+        shards[i]->clear();
+    }
+    nb = 0;
+}
+
+template<class K, class V, class Compare, typename TRandom, int MaxLevel>
+void sharded_skiplist<K, V, Compare, TRandom, MaxLevel>::rebalance() {
+    std::unique_lock<std::shared_mutex> guard(partition);
+    for(size_t i=0; i < shards.size(); i++) {
+        relieve(i);
+    }
+}
+
+template<class K, class V, class Compare, typename TRandom, int MaxLevel>
+K sharded_skiplist<K, V, Compare, TRandom, MaxLevel>::key_at(const shard_type& shard, size_t rank) const {
+    // walks from the nearer end
+    if(rank < shard.size() - rank) {
+        auto it = shard.cbegin();
+        for(size_t r=0; r < rank; r++) ++it;
+        return *(it->first);
+    }
+    auto it = shard.cend();
+    for(size_t r=shard.size(); r > rank; r--) --it;
+    return *(it->first);
+}
+
+template<class K, class V, class Compare, typename TRandom, int MaxLevel>
+void sharded_skiplist<K, V, Compare, TRandom, MaxLevel>::relieve(size_t i) {
+    // called with the partition lock held exclusive; the keys of shard i
+    // above the average go to a shard not in use yet if there is one, else
+    // to the smaller neighbour, and a neighbour pushed over the threshold
+    // passes its own surplus on in the same direction
+    int step = 0;
+    while(i < shards.size() && skewed(shards[i]->size())) {
+        shard_type& shard = *shards[i];
+        size_t used = bounds.size() + 1, target = std::max<size_t>(nb / shards.size(), 1);
+        if(shard.size() <= target + 1) return;
+        shard_type tail(shard.get_prob());
+
+        if(used < shards.size()) {
+            // shard i keeps target keys, the rest starts the next shard
+            K k = key_at(shard, target);
+            shard.split(k, tail);
+            std::rotate(shards.begin() + i + 1, shards.begin() + used, shards.begin() + used + 1);
+            shards[i + 1]->swap(tail);
+            bounds.insert(bounds.begin() + i, k);
+            i++;
+            step = 1;
+            continue;
+        }
+
+        if(step == 0) step = i + 1 < used && (i == 0 || shards[i + 1]->size() < shards[i - 1]->size()) ? 1 : -1;
+        if((step > 0 && i + 1 == used) || (step < 0 && i == 0)) return;
+        if(step > 0) {
+            K k = key_at(shard, target);
+            shard.split(k, tail);
+            tail.append(*shards[i + 1]);
+            shards[i + 1]->swap(tail);
+            bounds[i] = k;
+        } else {
+            K k = key_at(shard, shard.size() - target);
+            shard.split(k, tail);
+            shards[i - 1]->append(shard);
+            shard.swap(tail);
+            bounds[i - 1] = k;
+        }
+        i += step;
+    }
+}
+
+template<class K, class V, class Compare, typename TRandom, int MaxLevel>
+template <class Function>
+void sharded_skiplist<K, V, Compare, TRandom, MaxLevel>::for_each(Function fn) const {
+    // shards are visited in key order, each under its own read lock
+    std::shared_lock<std::shared_mutex> guard(partition);
+    for(size_t i=0; i < shards.size(); i++) {
+        std::shared_lock<std::shared_mutex> lock(locks[i]);
+        const shard_type& shard = *shards[i];
+        for(auto it=shard.cbegin(); it != shard.cend(); ++it) {
+            fn(*(it->first), *(it->second));
+        }
+    }
+}
+
+template<class K, class V, class Compare, typename TRandom, int MaxLevel>
+template <class Function>
+void sharded_skiplist<K, V, Compare, TRandom, MaxLevel>::for_each(const K& lo, const K& hi, Function fn) const {
+    if(! Compare()(lo, hi)) return;
+    std::shared_lock<std::shared_mutex> guard(partition);
+    for(size_t i=shard_of(lo); i <= shard_of(hi) && i < shards.size(); i++) {
+        std::shared_lock<std::shared_mutex> lock(locks[i]);
+        const shard_type& shard = *shards[i];
+        for(auto it=shard.lower_bound(lo); it != shard.cend() && Compare()(*(it->first), hi); ++it) {
+            fn(*(it->first), *(it->second));
+        }
+    }
+}
+
+#endif // SHARDED_SKIPLIST_H
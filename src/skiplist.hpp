@@ -8,47 +8,113 @@
 #include <cassert>
 #include <chrono>
 #include <utility>
+#include <thread>
+#include <future>
+#include <algorithm>
+#include <type_traits>
 #include "slnode.hpp"
 #include "skiplist_exceptions.hpp"
+#include "skiplist_monoids.hpp"
+#if __cplusplus >= 202002L
+#include <ranges>
+#endif
+
+#if defined(__GNUC__) || defined(__clang__)
+#define SKIPLIST_PREFETCH(p) __builtin_prefetch(p)
+#else
+#define SKIPLIST_PREFETCH(p) ((void) 0)
+#endif
 
 enum orientation {
     VERTICAL = 0,
     HORIZONTAL
 };
 
+enum eviction_policy {
+    NO_EVICTION = 0,
+    EVICT_SMALLEST,
+    EVICT_LARGEST,
+    EVICT_LRU
+};
+
 
 
-template<class K, class V, class Compare=std::less<K>, typename TRandom=std::default_random_engine, int MaxLevel=10>
+template<class K, class V, class Compare=std::less<K>, typename TRandom=std::default_random_engine, int MaxLevel=10, class Monoid=void, bool Recency=false>
 class skiplist {
-    std::vector<SLNode<K, V>*> levels;
-    SLNode<K, V>* last;
+    // augmented skiplists store their values const, so that operator[], at(),
+    // iterators and cursors cannot write past the aggregates
+    typedef typename std::conditional<std::is_void<Monoid>::value, V, const V>::type stored_value;
+    typedef SLNode<K, stored_value, typename skiplist_aggregate<Monoid>::type, Recency> slnode;
+
+    std::vector<slnode*> levels;
+    slnode* last;
     double prob;
     size_t nb;
     TRandom generator;
 
+    size_t nodes;
+    size_t capacity;
+    size_t byte_capacity;
+    eviction_policy policy;
+    slnode* recent;
+    slnode* oldest;
+
+    slnode* seek(const K& e) const;
+    std::vector<slnode*> partition(slnode* first, slnode* stop, unsigned int chunks) const;
+    template <class Function> void for_each_chunk(slnode* first, slnode* stop, Function& fn, unsigned int threads) const;
+    template <class T, class Accumulate, class Combine> 
+    T reduce_chunks(slnode* first, slnode* stop, const T& identity, Accumulate& acc, Combine& combine, unsigned int threads) const;
+
+    void refresh(slnode* x);
+    void refresh_path(slnode* a, slnode* b=nullptr);
+    bool covered(const slnode* x, const K& hi) const;
+
+    template <class... Args> slnode* make_node(Args... args) { nodes++; return new slnode(args...); }
+    void drop_node(slnode* x) { nodes--; delete x; }
+    void touch(slnode* x);
+    void forget(slnode* x);
+    bool over_budget() const;
+    void evict(const slnode* keep);
+    void take(skiplist& sk);
+    size_t count_cut(const std::vector<slnode*>& cut, int height, size_t total) const;
+
 public:
-    typedef std::pair<const K* const, V* const> value_type;
+    typedef std::pair<const K*, stored_value*> value_type;
+    typedef typename skiplist_aggregate<Monoid>::type aggregate_type;
     class iterator;
     class const_iterator;
+    template <class R> class basic_cursor;
+    template <class R> class basic_range;
+    typedef basic_cursor<stored_value> cursor;
+    typedef basic_cursor<const V> const_cursor;
+    typedef basic_range<stored_value> range_view;
+    typedef basic_range<const V> const_range_view;
 
     skiplist(double p=0.5);
     template <class Iterator> skiplist(const Iterator& first_element, const Iterator& last_element, double p=0.5);
-    skiplist(const skiplist<K, V, Compare, TRandom, MaxLevel>& sk);
-    skiplist<K, V, Compare, TRandom, MaxLevel>& operator=(const skiplist<K, V, Compare, TRandom, MaxLevel>& sk);
+    skiplist(const skiplist<K, V, Compare, TRandom, MaxLevel, Monoid, Recency>& sk);
+    skiplist<K, V, Compare, TRandom, MaxLevel, Monoid, Recency>& operator=(const skiplist<K, V, Compare, TRandom, MaxLevel, Monoid, Recency>& sk);
 
     ~skiplist() { clear(); }
     size_t size() const { return nb; }
     void clear();
     double get_prob() const { return prob; }
+
+    void set_capacity(size_t entries, size_t bytes=0, eviction_policy policy=Recency? EVICT_LRU : EVICT_SMALLEST);
+    size_t get_capacity() const { return capacity; }
+    size_t get_byte_capacity() const { return byte_capacity; }
+    eviction_policy get_eviction_policy() const { return policy; }
+    size_t memory_usage() const { return nodes * sizeof(slnode) + nb * (sizeof(K) + sizeof(V)); }
     bool exists(const K& e) const;
 
     std::pair<iterator, bool> insert(K k, V v) {
-        value_type kv = make_pair(&k, &v);
+        value_type kv = std::make_pair(&k, &v);
         return insert(kv);
     }
     std::pair<iterator, bool> insert(const value_type& p);
     std::pair<iterator, bool> insert(iterator& it, const value_type& p);
     template <class InputIterator> void insert(InputIterator first, InputIterator last);
+    std::pair<iterator, bool> insert_or_assign(const K& k, const V& v);
 
     void sketch(orientation orient=VERTICAL) const;
     
@@ -57,10 +123,13 @@ public:
     unsigned int count(const K& e) const { return (exists(e))? 1 : 0; }
     const K& front() const;
     const K& back() const;
+    void pop_front();
+    void pop_back();
+    std::pair<iterator, bool> update_key(iterator it, const K& k);
 
-    V& operator[](const K& k);
+    stored_value& operator[](const K& k);
     const V& at(const K& k) const;
-    V& at(const K& k);
+    stored_value& at(const K& k);
 
     iterator begin() { return iterator(*this, levels.front()); }
     iterator end() { return iterator(*this, nullptr); }
@@ -84,11 +153,29 @@ public:
     const_iterator upper_bound(const K& e) const;
 
     void swap(skiplist& sk);
+    void split(const K& k, skiplist& tail);
+    void append(skiplist& sk);
+    void check_invariants() const;
+
+    template <class Function> void parallel_for_each(const K& lo, const K& hi, Function fn, unsigned int threads=std::thread::hardware_concurrency()) const;
+    template <class Function> void parallel_for_each(Function fn, unsigned int threads=std::thread::hardware_concurrency()) const;
+    template <class T, class Accumulate, class Combine> 
+    T parallel_reduce(const K& lo, const K& hi, T identity, Accumulate acc, Combine combine, unsigned int threads=std::thread::hardware_concurrency()) const;
+    template <class T, class Accumulate, class Combine> 
+    T parallel_reduce(T identity, Accumulate acc, Combine combine, unsigned int threads=std::thread::hardware_concurrency()) const;
+
+    aggregate_type aggregate(const K& lo, const K& hi) const;
+    aggregate_type aggregate() const;
+
+    cursor cursor_at(const K& lo, unsigned int distance=4);
+    const_cursor cursor_at(const K& lo, unsigned int distance=4) const;
+    range_view range(const K& lo, const K& hi, unsigned int distance=4);
+    const_range_view range(const K& lo, const K& hi, unsigned int distance=4) const;
 
     class iterator : public std::iterator< std::bidirectional_iterator_tag, value_type>
     {
     public:
-        iterator(const skiplist<K, V, Compare, TRandom, MaxLevel>& sk, SLNode<K, V>* c=nullptr): sk(&sk), current(c) {}
+        iterator(const skiplist<K, V, Compare, TRandom, MaxLevel, Monoid, Recency>& sk, slnode* c=nullptr): current(c), sk(&sk) {}
 
         const value_type& operator*() const { return current->get_key_value(); }
         const value_type* operator->() const { return &(current->get_key_value()); }
@@ -101,7 +188,7 @@ public:
         iterator operator++(int) { 
             iterator tmp = *this; 
             if(! current) current = sk->levels.front();  
-            else current = current->get_prev(); 
+            else current = current->get_next(); 
             return tmp; 
          }
         iterator& operator--() { 
@@ -142,18 +229,19 @@ public:
 
         friend bool operator== (const iterator& a, const iterator& b)  { return a.current==b.current && a.sk==b.sk; }
         friend bool operator!= (const iterator& a, const iterator& b)  { return a.current!=b.current || a.sk!=b.sk; }
-        friend void skiplist<K, V, Compare, TRandom, MaxLevel>::erase(iterator it);
+        friend void skiplist<K, V, Compare, TRandom, MaxLevel, Monoid, Recency>::erase(iterator it);
+        friend std::pair<iterator, bool> skiplist<K, V, Compare, TRandom, MaxLevel, Monoid, Recency>::update_key(iterator it, const K& k);
     private:
-        SLNode<K, V>* current;
-        const skiplist<K, V, Compare, TRandom, MaxLevel>* sk;
+        slnode* current;
+        const skiplist<K, V, Compare, TRandom, MaxLevel, Monoid, Recency>* sk;
         friend const_iterator::const_iterator(const iterator& it);
     };
 
     class const_iterator : public std::iterator< std::bidirectional_iterator_tag, value_type>
     {
     public:
-        const_iterator(const skiplist<K, V, Compare, TRandom, MaxLevel>& sk, SLNode<K, V>* c=nullptr): sk(&sk), current(c) {}
-        const_iterator(const iterator& it): sk(it.sk), current(it.current) {}
+        const_iterator(const skiplist<K, V, Compare, TRandom, MaxLevel, Monoid, Recency>& sk, slnode* c=nullptr): current(c), sk(&sk) {}
+        const_iterator(const iterator& it): current(it.current), sk(it.sk) {}
         const value_type& operator*() const { return current->get_key_value(); }
         const value_type* const operator->() const { return &(current->get_key_value()); }
 
@@ -165,7 +253,7 @@ public:
         const_iterator operator++(int) { 
             const_iterator tmp = *this; 
             if(! current) current = sk->levels.front();  
-            else current = current->get_prev(); 
+            else current = current->get_next(); 
             return tmp; 
          }
         const_iterator& operator--() { 
@@ -175,7 +263,7 @@ public:
         }  
         const_iterator operator--(int) { 
             const_iterator tmp = *this; 
-            if(! current) current = sk.last;  
+            if(! current) current = sk->last;  
             else current = current->get_prev(); 
             return tmp; 
         }
@@ -207,14 +295,89 @@ public:
         friend bool operator== (const const_iterator& a, const const_iterator& b)  { return a.current==b.current && a.sk==b.sk; };
         friend bool operator!= (const const_iterator& a, const const_iterator& b)  { return a.current!=b.current || a.sk!=b.sk; };  
     private:
-        SLNode<K, V>* current;
-        const skiplist<K, V, Compare, TRandom, MaxLevel>* sk;
+        slnode* current;
+        const skiplist<K, V, Compare, TRandom, MaxLevel, Monoid, Recency>* sk;
+    };
+    // Lightweight forward cursor over level 0: no back-pointer to the list and
+    // no end check on next(). It keeps a pointer `distance` nodes ahead and
+    // prefetches that node and the key and value the step before reaches.
+    template <class R>
+    class basic_cursor {
+    public:
+        basic_cursor(slnode* c=nullptr, slnode* stop=nullptr, unsigned int distance=4): current(c), stop(stop), ahead(c) {
+            for(unsigned int i=0; ahead && i < distance; i++) {
+                ahead = ahead->get_next();
+            }
+            if(distance == 0) ahead = nullptr;
+        }
+
+        bool valid() const { return current != stop; }
+        const K& key() const { return *(current->get_key_value().first); }
+        R& value() const { return *(current->get_key_value().second); }
+
+        basic_cursor& next() {
+            if(ahead) {
+                SKIPLIST_PREFETCH(ahead->get_key_value().first);
+                SKIPLIST_PREFETCH(ahead->get_key_value().second);
+                ahead = ahead->get_next();
+                SKIPLIST_PREFETCH(ahead);
+            }
+            current = current->get_next();
+            return *this;
+        }
+
+        friend bool operator== (const basic_cursor& a, const basic_cursor& b) { return a.current==b.current; }
+        friend bool operator!= (const basic_cursor& a, const basic_cursor& b) { return a.current!=b.current; }
+    private:
+        slnode* current;
+        slnode* stop;
+        slnode* ahead;
+    };
+
+    // View over [lower_bound(lo), upper_bound(hi)) handing out key and value
+    // references; a std::ranges::view when built as C++20.
+    template <class R>
+    class basic_range
+#if __cplusplus >= 202002L
+        : public std::ranges::view_interface<basic_range<R>>
+#endif
+    {
+    public:
+        class iterator {
+        public:
+            typedef std::forward_iterator_tag iterator_category;
+            typedef std::pair<const K&, R&> value_type;
+            typedef std::pair<const K&, R&> reference;
+            typedef std::ptrdiff_t difference_type;
+
+            iterator(): c() {}
+            iterator(const basic_cursor<R>& c): c(c) {}
+
+            reference operator*() const { return reference(c.key(), c.value()); }
+            iterator& operator++() { c.next(); return *this; }
+            iterator operator++(int) { iterator tmp = *this; c.next(); return tmp; }
+
+            friend bool operator== (const iterator& a, const iterator& b) { return a.c==b.c; }
+            friend bool operator!= (const iterator& a, const iterator& b) { return a.c!=b.c; }
+        private:
+            basic_cursor<R> c;
+        };
+
+        basic_range(slnode* first=nullptr, slnode* stop=nullptr, unsigned int distance=4): first(first), stop(stop), distance(distance) {}
+
+        iterator begin() const { return iterator(basic_cursor<R>(first, stop, distance)); }
+        iterator end() const { return iterator(basic_cursor<R>(stop, stop, 0)); }
+        bool empty() const { return first == stop; }
+    private:
+        slnode* first;
+        slnode* stop;
+        unsigned int distance;
     };
 };
 
 
-template<class K, class V, class Compare, typename TRandom, int MaxLevel>
-void skiplist<K, V, Compare, TRandom, MaxLevel>::print() const {
+template<class K, class V, class Compare, typename TRandom, int MaxLevel, class Monoid, bool Recency>
+void skiplist<K, V, Compare, TRandom, MaxLevel, Monoid, Recency>::print() const {
     std::cout << "skiplist: ";
     for(auto it=cbegin(); it != cend(); ++it) {
         std::cout << *(it->first) << " ";
@@ -222,8 +385,8 @@ void skiplist<K, V, Compare, TRandom, MaxLevel>::print() const {
     std::cout << std::endl;
 }
 
-template<class K, class V, class Compare, typename TRandom, int MaxLevel>
-void skiplist<K, V, Compare, TRandom, MaxLevel>::sketch(orientation orient) const {
+template<class K, class V, class Compare, typename TRandom, int MaxLevel, class Monoid, bool Recency>
+void skiplist<K, V, Compare, TRandom, MaxLevel, Monoid, Recency>::sketch(orientation orient) const {
     if(empty()) {
         std::cout << "{{ skiplit empty }}" << std::endl;
         return;
@@ -256,42 +419,47 @@ void skiplist<K, V, Compare, TRandom, MaxLevel>::sketch(orientation orient) cons
 }
 
 
-template<class K, class V, class Compare, typename TRandom, int MaxLevel>
-skiplist<K, V, Compare, TRandom, MaxLevel>::skiplist(double p): levels(MaxLevel, nullptr), prob(p), nb(0),
-        generator(std::chrono::system_clock::now().time_since_epoch().count()), last(nullptr) {}
+template<class K, class V, class Compare, typename TRandom, int MaxLevel, class Monoid, bool Recency>
+skiplist<K, V, Compare, TRandom, MaxLevel, Monoid, Recency>::skiplist(double p): levels(MaxLevel, nullptr), last(nullptr), prob(p), nb(0),
+        generator(std::chrono::system_clock::now().time_since_epoch().count()),
+        nodes(0), capacity(0), byte_capacity(0), policy(NO_EVICTION), recent(nullptr), oldest(nullptr) {}
 
-template<class K, class V, class Compare, typename TRandom, int MaxLevel>
+template<class K, class V, class Compare, typename TRandom, int MaxLevel, class Monoid, bool Recency>
 template <typename Iterator>
-skiplist<K, V, Compare, TRandom, MaxLevel>::skiplist(const Iterator& first_element, const Iterator& last_element, double p): levels(MaxLevel, nullptr), prob(p),
-        generator(std::chrono::system_clock::now().time_since_epoch().count()), nb(0) {
+skiplist<K, V, Compare, TRandom, MaxLevel, Monoid, Recency>::skiplist(const Iterator& first_element, const Iterator& last_element, double p): levels(MaxLevel, nullptr), last(nullptr), prob(p), nb(0),
+        generator(std::chrono::system_clock::now().time_since_epoch().count()),
+        nodes(0), capacity(0), byte_capacity(0), policy(NO_EVICTION), recent(nullptr), oldest(nullptr) {
     insert(first_element, last_element);
 }
 
-template<class K, class V, class Compare, typename TRandom, int MaxLevel>
-skiplist<K, V, Compare, TRandom, MaxLevel>::skiplist(const skiplist<K, V, Compare, TRandom, MaxLevel>& sk): skiplist(sk.cbegin(), sk.cend(), sk.prob) {}
+template<class K, class V, class Compare, typename TRandom, int MaxLevel, class Monoid, bool Recency>
+skiplist<K, V, Compare, TRandom, MaxLevel, Monoid, Recency>::skiplist(const skiplist<K, V, Compare, TRandom, MaxLevel, Monoid, Recency>& sk): skiplist(sk.cbegin(), sk.cend(), sk.prob) {
+    set_capacity(sk.capacity, sk.byte_capacity, sk.policy);
+}
 
-template<class K, class V, class Compare, typename TRandom, int MaxLevel>
-skiplist<K, V, Compare, TRandom, MaxLevel>& skiplist<K, V, Compare, TRandom, MaxLevel>::operator=(const skiplist<K, V, Compare, TRandom, MaxLevel>& sk) {
+template<class K, class V, class Compare, typename TRandom, int MaxLevel, class Monoid, bool Recency>
+skiplist<K, V, Compare, TRandom, MaxLevel, Monoid, Recency>& skiplist<K, V, Compare, TRandom, MaxLevel, Monoid, Recency>::operator=(const skiplist<K, V, Compare, TRandom, MaxLevel, Monoid, Recency>& sk) {
     if(this != &sk) {
         clear();
         prob = sk.prob;
+        set_capacity(sk.capacity, sk.byte_capacity, sk.policy);
         insert(sk.cbegin(), sk.cend());
     }
     return *this;
 }
 
 
-template<class K, class V, class Compare, typename TRandom, int MaxLevel>
-void skiplist<K, V, Compare, TRandom, MaxLevel>::clear() {
-    SLNode<K, V>* p = levels.front();
-    const K* k; V* v;
+template<class K, class V, class Compare, typename TRandom, int MaxLevel, class Monoid, bool Recency>
+void skiplist<K, V, Compare, TRandom, MaxLevel, Monoid, Recency>::clear() {
+    slnode* p = levels.front();
+    const K* k; stored_value* v;
     while(p) {
-        SLNode<K, V>* q = p;
+        slnode* q = p;
         p = p->get_next();
         std::tie(k, v) = q->get_key_value();
         while(q) {
-            SLNode<K, V>* tmp = q->get_up();
-            delete q;
+            slnode* tmp = q->get_up();
+            drop_node(q);
             q = tmp;
         }
         delete k;
@@ -302,56 +470,62 @@ void skiplist<K, V, Compare, TRandom, MaxLevel>::clear() {
     }
     last = nullptr;
     nb = 0;
+    recent = nullptr;
+    oldest = nullptr;
 }
 
-template<class K, class V, class Compare, typename TRandom, int MaxLevel>
-bool skiplist<K, V, Compare, TRandom, MaxLevel>::exists(const K& e) const {
+template<class K, class V, class Compare, typename TRandom, int MaxLevel, class Monoid, bool Recency>
+bool skiplist<K, V, Compare, TRandom, MaxLevel, Monoid, Recency>::exists(const K& e) const {
     if(empty()) return false;
-    SLNode<K, V>* p = levels.back();
-    if(Compare()(e, p->get_val())) return false;
-    if(p->get_val() == e) return true;
+    slnode* p = levels.back();
+    if(Compare()(e, p->get_key())) return false;
+    if(p->get_key() == e) return true;
 
     while(p) {
-        while(p->get_next() && Compare()(p->get_next()->get_val(), e)) {
+        while(p->get_next() && Compare()(p->get_next()->get_key(), e)) {
             p = p->get_next();
         }
-        if(p->get_next() && p->get_next()->get_val() == e) return true;
+        if(p->get_next() && p->get_next()->get_key() == e) return true;
         p = p->get_down();
     }
     return false;
 }
 
-template<class K, class V, class Compare, typename TRandom, int MaxLevel>
-std::pair<typename skiplist<K, V, Compare, TRandom, MaxLevel>::iterator, bool> skiplist<K, V, Compare, TRandom, MaxLevel>::insert(const value_type& p) {
+template<class K, class V, class Compare, typename TRandom, int MaxLevel, class Monoid, bool Recency>
+std::pair<typename skiplist<K, V, Compare, TRandom, MaxLevel, Monoid, Recency>::iterator, bool> skiplist<K, V, Compare, TRandom, MaxLevel, Monoid, Recency>::insert(const value_type& p) {
     if(empty()) {
         const K* const k = new K(*p.first);
         V* v = new V(*p.second);
 
-        levels[0] = new SLNode<K, V>(k, v);
+        levels[0] = make_node(k, v);
         for(int i=1; i < levels.size(); i++) {
-            levels[i] = new SLNode<K, V>(k, v);
+            levels[i] = make_node(k, v);
             levels[i]->set_down(levels[i-1]);
             levels[i-1]->set_up(levels[i]);
         }
         nb++;
         last = levels.front();
+        refresh_path(levels.front());
+        touch(levels.front());
+        evict(levels.front());
         return {begin(), true};
     } else if(*p.first == levels.front()->get_key()) {
+        touch(levels.front());
         return {begin(), false};
     } else if(Compare()(*p.first, levels.front()->get_key())) {
         const K* const k = new K(*p.first);
         V* v = new V(*p.second);
 
-        levels[0] = new SLNode<K, V>(k, v, levels[0]);
+        levels[0] = make_node(k, v, levels[0]);
         levels[0]->get_next()->set_prev(levels[0]);
         for(int i=1; i < levels.size(); i++) {
-            levels[i] = new SLNode<K, V>(k, v, levels[i]);
+            levels[i] = make_node(k, v, levels[i]);
             levels[i]->get_next()->set_prev(levels[i]);
             levels[i]->set_down(levels[i-1]);
             levels[i-1]->set_up(levels[i]);
         }
 
-        SLNode<K, V>* next = levels.front()->get_next(), *tmp = nullptr;
+        slnode* next = levels.front()->get_next(), *tmp = nullptr;
         while(next->get_up() && generator() < (generator.max() + generator.min()) * this->prob) {
             next = next->get_up();
         }
@@ -363,20 +537,28 @@ std::pair<typename skiplist<K, V, Compare, TRandom, MaxLevel>::iterator, bool> s
             tmp = next->get_up();
             next->get_prev()->set_next(next->get_next());
             if(next->get_next()) next->get_next()->set_prev(next->get_prev());
-            delete next;
+            drop_node(next);
             next = tmp;
         }
         nb++;
+        refresh_path(levels.front(), levels.front()->get_next());
+        touch(levels.front());
+        evict(levels.front());
         return {begin(), true};
     } else {
-        std::vector<SLNode<K, V>*> previous = levels;
+        std::vector<slnode*> previous = levels;
         int i = MaxLevel - 1;
         while(i>0) {
             while(previous[i]->get_next() && Compare()(previous[i]->get_next()->get_key(), *p.first)) {
                 previous[i] = previous[i]->get_next();
             }
             if(previous[i]->get_next() && previous[i]->get_next()->get_key() == *p.first) {
-                return { iterator(*this, previous[i]->get_next()), false };
+                slnode* q = previous[i]->get_next();
+                while(q->get_down()) {
+                    q = q->get_down();
+                }
+                touch(q);
+                return { iterator(*this, q), false };
             }
             previous[i-1] = previous[i]->get_down();
             i--;
@@ -385,12 +567,15 @@ std::pair<typename skiplist<K, V, Compare, TRandom, MaxLevel>::iterator, bool> s
         while(previous[0]->get_next() && Compare()(previous[0]->get_next()->get_key(), *p.first)) {
             previous[0] = previous[0]->get_next();
         }
-        if(previous[0]->get_next() && previous[0]->get_next()->get_key() == *p.first) return { iterator(*this, previous[0]->get_next()), false };
+        if(previous[0]->get_next() && previous[0]->get_next()->get_key() == *p.first) {
+            touch(previous[0]->get_next());
+            return { iterator(*this, previous[0]->get_next()), false };
+        }
 
         // add to level 0
         const K* const k = new K(*p.first);
         V* v = new V(*p.second);
-        auto node = new SLNode<K, V>(k, v, previous[0]->get_next(), previous[0]);
+        auto node = make_node(k, v, previous[0]->get_next(), previous[0]);
         if(node->get_next()) node->get_next()->set_prev(node);
         previous[0]->set_next(node);
 
@@ -399,9 +584,9 @@ std::pair<typename skiplist<K, V, Compare, TRandom, MaxLevel>::iterator, bool> s
         }
 
         i = 1;
-        SLNode<K, V>* nDown = node;
+        slnode* nDown = node;
         while(i < MaxLevel && generator() < (generator.max() + generator.min()) * this->prob) {
-            auto node = new SLNode<K, V>(k, v, previous[i]->get_next(), previous[i], nullptr, nDown);
+            auto node = make_node(k, v, previous[i]->get_next(), previous[i], nullptr, nDown);
             nDown->set_up(node);
             if(node->get_next()) node->get_next()->set_prev(node);
             previous[i]->set_next(node);
@@ -410,43 +595,220 @@ std::pair<typename skiplist<K, V, Compare, TRandom, MaxLevel>::iterator, bool> s
             i++;
         }
         nb++;
+        refresh_path(node, previous[0]);
+        touch(node);
+        evict(node);
         return {iterator(*this, node), true};
     }
 }
 
-template<class K, class V, class Compare, typename TRandom, int MaxLevel>
-std::pair<typename skiplist<K, V, Compare, TRandom, MaxLevel>::iterator, bool> skiplist<K, V, Compare, TRandom, MaxLevel>::insert(typename skiplist<K, V, Compare, TRandom, MaxLevel>::iterator& it, const value_type& p) {
+template<class K, class V, class Compare, typename TRandom, int MaxLevel, class Monoid, bool Recency>
+std::pair<typename skiplist<K, V, Compare, TRandom, MaxLevel, Monoid, Recency>::iterator, bool> skiplist<K, V, Compare, TRandom, MaxLevel, Monoid, Recency>::insert(typename skiplist<K, V, Compare, TRandom, MaxLevel, Monoid, Recency>::iterator& it, const value_type& p) {
     // temporary version
     return insert(p);
 }
 
 
-template<class K, class V, class Compare, typename TRandom, int MaxLevel>
+template<class K, class V, class Compare, typename TRandom, int MaxLevel, class Monoid, bool Recency>
 template <class InputIterator> 
-void skiplist<K, V, Compare, TRandom, MaxLevel>::insert (InputIterator first_element, InputIterator last_element) {
+void skiplist<K, V, Compare, TRandom, MaxLevel, Monoid, Recency>::insert (InputIterator first_element, InputIterator last_element) {
     for(auto it=first_element; it != last_element; ++it) {
         insert({it->first, it->second});      
     }
 }
 
-template<class K, class V, class Compare, typename TRandom, int MaxLevel>
-const K& skiplist<K, V, Compare, TRandom, MaxLevel>::front() const {
+template<class K, class V, class Compare, typename TRandom, int MaxLevel, class Monoid, bool Recency>
+std::pair<typename skiplist<K, V, Compare, TRandom, MaxLevel, Monoid, Recency>::iterator, bool> skiplist<K, V, Compare, TRandom, MaxLevel, Monoid, Recency>::insert_or_assign(const K& k, const V& v) {
+    // the only write path of augmented skiplists: their values are stored
+    // const but were allocated as V, so the cast is safe
+    auto ans = insert(k, v);
+    if(! ans.second) {
+        *const_cast<V*>(ans.first->second) = v;
+        refresh_path(seek(k));
+    }
+    return ans;
+}
+
+template<class K, class V, class Compare, typename TRandom, int MaxLevel, class Monoid, bool Recency>
+void skiplist<K, V, Compare, TRandom, MaxLevel, Monoid, Recency>::pop_front() {
+    if(empty()) throw SkiplistException("Calling pop_front method on an empty skiplist");
+    erase(begin());
+}
+
+template<class K, class V, class Compare, typename TRandom, int MaxLevel, class Monoid, bool Recency>
+void skiplist<K, V, Compare, TRandom, MaxLevel, Monoid, Recency>::pop_back() {
+    if(empty()) throw SkiplistException("Calling pop_back method on an empty skiplist");
+    erase(iterator(*this, last));
+}
+
+template<class K, class V, class Compare, typename TRandom, int MaxLevel, class Monoid, bool Recency>
+std::pair<typename skiplist<K, V, Compare, TRandom, MaxLevel, Monoid, Recency>::iterator, bool> skiplist<K, V, Compare, TRandom, MaxLevel, Monoid, Recency>::update_key(typename skiplist<K, V, Compare, TRandom, MaxLevel, Monoid, Recency>::iterator it, const K& k) {
+    // like insert, every path makes the returned node the most recent one
+    if(it == end()) throw SkiplistException("Calling update_key method on end iterator");
+    slnode* x = it.current;
+    K* key = const_cast<K*>(x->get_key_value().first);
+    if(*key == k) {
+        touch(x);
+        return {it, true};
+    }
+
+    slnode* found = seek(k);
+    if(found && found->get_key() == k) {
+        touch(found);
+        return {iterator(*this, found), false};
+    }
+
+    // the node keeps its place when no other key lies between the old and the new one
+    if((! x->get_prev() || Compare()(x->get_prev()->get_key(), k)) && (! x->get_next() || Compare()(k, x->get_next()->get_key()))) {
+        *key = k;
+        refresh_path(x);
+        touch(x);
+        return {it, true};
+    }
+
+    // the front owns the full height head tower: when it moves back, the next
+    // node is promoted as in erase and the head nodes under its height go
+    // with the front as its new tower
+    if(x == levels.front()) {
+        slnode* q = x->get_next();
+        int h = 0;
+        for(slnode* t = q; t; t = t->get_up(), h++) {
+            t->set_prev(nullptr);
+            levels[h] = t;
+        }
+        slnode* top = x;
+        for(int i=1; i < h; i++) {
+            top = top->get_up();
+        }
+        if(h < MaxLevel) {
+            levels[h]->set_down(levels[h-1]);
+            levels[h-1]->set_up(levels[h]);
+            top->set_up(nullptr);
+            for(int i=h; i < MaxLevel; i++) {
+                levels[i]->set_key_value(q->get_key_value().first, q->get_key_value().second);
+            }
+        }
+        *key = k;
+
+        std::vector<slnode*> previous(h, nullptr);
+        slnode* p = levels.back();
+        for(int i=MaxLevel - 1; i >= 0; i--) {
+            while(p->get_next() && Compare()(p->get_next()->get_key(), k)) {
+                p = p->get_next();
+            }
+            if(i < h) previous[i] = p;
+            p = p->get_down();
+        }
+        int i = 0;
+        for(slnode* t = x; t; t = t->get_up(), i++) {
+            t->set_prev(previous[i]);
+            t->set_next(previous[i]->get_next());
+            if(t->get_next()) t->get_next()->set_prev(t);
+            previous[i]->set_next(t);
+        }
+        if(! x->get_next()) last = x;
+        refresh_path(levels.front());
+        refresh_path(x, previous[0]);
+        touch(x);
+        return {iterator(*this, x), true};
+    }
+
+    slnode* previous = x->get_prev();
+    if(x == last) last = previous;
+    for(slnode* t = x; t; t = t->get_up()) {
+        t->get_prev()->set_next(t->get_next());
+        if(t->get_next()) t->get_next()->set_prev(t->get_prev());
+    }
+    *key = k;
+
+    // a new minimum goes in front of the head tower, whose nodes above its
+    // height take its key and value; the old front keeps the rest, trimmed
+    // to a random height as in insert
+    if(Compare()(k, levels.front()->get_key())) {
+        slnode* front = levels.front();
+        int h = 0;
+        slnode* top = x;
+        for(slnode* t = x; t; t = t->get_up(), h++) {
+            t->set_prev(nullptr);
+            t->set_next(levels[h]);
+            levels[h]->set_prev(t);
+            levels[h] = t;
+            top = t;
+        }
+        if(h < MaxLevel) {
+            top->get_next()->set_up(nullptr);
+            levels[h]->set_down(top);
+            top->set_up(levels[h]);
+            for(int i=h; i < MaxLevel; i++) {
+                levels[i]->set_key_value(x->get_key_value().first, x->get_key_value().second);
+            }
+        }
+
+        slnode* next = front, *tmp = nullptr;
+        while(next->get_up() && generator() < (generator.max() + generator.min()) * this->prob) {
+            next = next->get_up();
+        }
+        tmp = next->get_up();
+        next->set_up(nullptr);
+        next = tmp;
+        while(next) {
+            tmp = next->get_up();
+            next->get_prev()->set_next(next->get_next());
+            if(next->get_next()) next->get_next()->set_prev(next->get_prev());
+            drop_node(next);
+            next = tmp;
+        }
+        refresh_path(previous);
+        refresh_path(x, front);
+        touch(x);
+        return {iterator(*this, x), true};
+    }
+    refresh_path(previous);
+
+    std::vector<slnode*> path(MaxLevel, nullptr);
+    slnode* p = levels.back();
+    for(int i=MaxLevel - 1; i >= 0; i--) {
+        while(p->get_next() && Compare()(p->get_next()->get_key(), k)) {
+            p = p->get_next();
+        }
+        path[i] = p;
+        p = p->get_down();
+    }
+
+    int i = 0;
+    for(slnode* t = x; t; t = t->get_up(), i++) {
+        t->set_prev(path[i]);
+        t->set_next(path[i]->get_next());
+        if(t->get_next()) t->get_next()->set_prev(t);
+        path[i]->set_next(t);
+    }
+    if(! x->get_next()) last = x;
+    refresh_path(x, path[0]);
+    touch(x);
+    return {iterator(*this, x), true};
+}
+
+template<class K, class V, class Compare, typename TRandom, int MaxLevel, class Monoid, bool Recency>
+const K& skiplist<K, V, Compare, TRandom, MaxLevel, Monoid, Recency>::front() const {
     if(empty()) throw SkiplistException("Calling front method on an empty skiplist");
     return levels.front()->get_key();
 }
 
-template<class K, class V, class Compare, typename TRandom, int MaxLevel>
-const K& skiplist<K, V, Compare, TRandom, MaxLevel>::back() const {
+template<class K, class V, class Compare, typename TRandom, int MaxLevel, class Monoid, bool Recency>
+const K& skiplist<K, V, Compare, TRandom, MaxLevel, Monoid, Recency>::back() const {
     if(empty()) throw SkiplistException("Calling back method on an empty skiplist");
     return last->get_key();
 }
 
-template<class K, class V, class Compare, typename TRandom, int MaxLevel> 
-typename skiplist<K, V, Compare, TRandom, MaxLevel>::iterator skiplist<K, V, Compare, TRandom, MaxLevel>::find(const K& e) {
+template<class K, class V, class Compare, typename TRandom, int MaxLevel, class Monoid, bool Recency> 
+typename skiplist<K, V, Compare, TRandom, MaxLevel, Monoid, Recency>::iterator skiplist<K, V, Compare, TRandom, MaxLevel, Monoid, Recency>::find(const K& e) {
     if(empty()) return end();
-    SLNode<K, V>* p = levels.back();
+    slnode* p = levels.back();
     if(Compare()(e, p->get_key())) return end();
-    if(p->get_key() == e) return begin();
+    if(p->get_key() == e) {
+        touch(levels.front());
+        return begin();
+    }
 
     while(p) {
         while(p->get_next() && Compare()(p->get_next()->get_key(), e)) {
@@ -457,6 +819,7 @@ typename skiplist<K, V, Compare, TRandom, MaxLevel>::iterator skiplist<K, V, Com
             while(p->get_down()) {
                 p = p->get_down();
             }
+            touch(p);
             return iterator(*this, p);
         }
         p = p->get_down();
@@ -464,10 +827,10 @@ typename skiplist<K, V, Compare, TRandom, MaxLevel>::iterator skiplist<K, V, Com
     return end();
 }
 
-template<class K, class V, class Compare, typename TRandom, int MaxLevel>
-typename skiplist<K, V, Compare, TRandom, MaxLevel>::const_iterator skiplist<K, V, Compare, TRandom, MaxLevel>::find(const K& e) const {
+template<class K, class V, class Compare, typename TRandom, int MaxLevel, class Monoid, bool Recency>
+typename skiplist<K, V, Compare, TRandom, MaxLevel, Monoid, Recency>::const_iterator skiplist<K, V, Compare, TRandom, MaxLevel, Monoid, Recency>::find(const K& e) const {
     if(empty()) return cend();
-    SLNode<K, V>* p = levels.back();
+    slnode* p = levels.back();
     if(Compare()(e, p->get_key())) return cend();
     if(p->get_key() == e) return cbegin();
 
@@ -480,53 +843,61 @@ typename skiplist<K, V, Compare, TRandom, MaxLevel>::const_iterator skiplist<K,
             while(p->get_down()) {
                 p = p->get_down();
             }
-            return const_iterator(p);
+            return const_iterator(*this, p);
         }
         p = p->get_down();
     }
     return cend();
 }
 
-template<class K, class V, class Compare, typename TRandom, int MaxLevel>
-void skiplist<K, V, Compare, TRandom, MaxLevel>::erase(typename skiplist<K, V, Compare, TRandom, MaxLevel>::iterator it) {
+template<class K, class V, class Compare, typename TRandom, int MaxLevel, class Monoid, bool Recency>
+void skiplist<K, V, Compare, TRandom, MaxLevel, Monoid, Recency>::erase(typename skiplist<K, V, Compare, TRandom, MaxLevel, Monoid, Recency>::iterator it) {
     if(it != end()) {
-        SLNode<K, V>* p = it.current;
+        slnode* p = it.current;
         if(p == last) last = last->get_prev();
+        forget(p);
         const K* k = it->first;
-        V* v = it->second;
+        stored_value* v = it->second;
 
         if(it == begin()) {
-            SLNode<K, V>* q = p->get_next();
+            slnode* q = p->get_next();
             if(q == nullptr) {
                 for(int i=0; i < MaxLevel; i++) {
-                    delete levels[i];
+                    drop_node(levels[i]);
                     levels[i] = nullptr;
                 }
             } else {
-                delete levels[0];
+                drop_node(levels[0]);
                 levels[0] = q;
                 q->set_prev(nullptr);
-                for(int i=1; i < MaxLevel; i++) {
-                    if(! q->get_up()) {
-                        q->set_up(new SLNode<K, V>(q->kv.first, q->kv.second, levels[i]->get_next(), nullptr, nullptr, q));
-                        if(levels[i]->get_next()) {
-                            levels[i]->get_next()->set_prev(q->get_up());
-                        }
-                    } 
+                int i = 1;
+                while(i < MaxLevel && q->get_up()) {
                     q = q->get_up();
                     q->set_prev(nullptr);
-                    delete levels[i];
-                    levels[i] = q; 
+                    drop_node(levels[i]);
+                    levels[i] = q;
+                    i++;
                 }
+                // above its own tower, the new front takes over the old head nodes
+                if(i < MaxLevel) {
+                    levels[i]->set_down(q);
+                    q->set_up(levels[i]);
+                    for(; i < MaxLevel; i++) {
+                        levels[i]->set_key_value(q->get_key_value().first, q->get_key_value().second);
+                    }
+                }
+                refresh_path(levels.front());
             }
         } else {
+            slnode* previous = p->get_prev();
             while(p) {
-                SLNode<K, V>* tmp = p->get_up();
+                slnode* tmp = p->get_up();
                 p->get_prev()->set_next(p->get_next());
                 if(p->get_next()) p->get_next()->set_prev(p->get_prev());
-                delete p;
+                drop_node(p);
                 p = tmp;
             }
+            refresh_path(previous);
         }
         nb--;
         delete k;
@@ -534,16 +905,16 @@ void skiplist<K, V, Compare, TRandom, MaxLevel>::erase(typename skiplist<K, V, C
     }
 }
 
-template<class K, class V, class Compare, typename TRandom, int MaxLevel>
-size_t skiplist<K, V, Compare, TRandom, MaxLevel>::erase(const K& e) {
+template<class K, class V, class Compare, typename TRandom, int MaxLevel, class Monoid, bool Recency>
+size_t skiplist<K, V, Compare, TRandom, MaxLevel, Monoid, Recency>::erase(const K& e) {
     auto it = find(e);
     size_t ans = (it == end())? 0:1;
     erase(it);
     return ans;
 }
 
-template<class K, class V, class Compare, typename TRandom, int MaxLevel>
-void skiplist<K, V, Compare, TRandom, MaxLevel>::erase(typename skiplist<K, V, Compare, TRandom, MaxLevel>::iterator first_element, typename skiplist<K, V, Compare, TRandom, MaxLevel>::iterator last_element){
+template<class K, class V, class Compare, typename TRandom, int MaxLevel, class Monoid, bool Recency>
+void skiplist<K, V, Compare, TRandom, MaxLevel, Monoid, Recency>::erase(typename skiplist<K, V, Compare, TRandom, MaxLevel, Monoid, Recency>::iterator first_element, typename skiplist<K, V, Compare, TRandom, MaxLevel, Monoid, Recency>::iterator last_element){
     auto it = first_element;
     while(it != last_element) {
         auto tmp = next(it);
@@ -552,10 +923,10 @@ void skiplist<K, V, Compare, TRandom, MaxLevel>::erase(typename skiplist<K, V, C
     }
 }
 
-template<class K, class V, class Compare, typename TRandom, int MaxLevel>
-typename skiplist<K, V, Compare, TRandom, MaxLevel>::iterator skiplist<K, V, Compare, TRandom, MaxLevel>::lower_bound(const K& e) {
+template<class K, class V, class Compare, typename TRandom, int MaxLevel, class Monoid, bool Recency>
+typename skiplist<K, V, Compare, TRandom, MaxLevel, Monoid, Recency>::iterator skiplist<K, V, Compare, TRandom, MaxLevel, Monoid, Recency>::lower_bound(const K& e) {
     if(empty()) return end();
-    SLNode<K, V>* p = levels.back(), *q = nullptr;
+    slnode* p = levels.back(), *q = nullptr;
     if(Compare()(e, p->get_key())) return begin();
     if(p->get_key() == e) return begin();
 
@@ -576,10 +947,10 @@ typename skiplist<K, V, Compare, TRandom, MaxLevel>::iterator skiplist<K, V, Com
     return iterator(*this, q->get_next());
 }
 
-template<class K, class V, class Compare, typename TRandom, int MaxLevel>
-typename skiplist<K, V, Compare, TRandom, MaxLevel>::const_iterator skiplist<K, V, Compare, TRandom, MaxLevel>::lower_bound(const K& e) const {
+template<class K, class V, class Compare, typename TRandom, int MaxLevel, class Monoid, bool Recency>
+typename skiplist<K, V, Compare, TRandom, MaxLevel, Monoid, Recency>::const_iterator skiplist<K, V, Compare, TRandom, MaxLevel, Monoid, Recency>::lower_bound(const K& e) const {
     if(empty()) return cend();
-    SLNode<K, V>* p = levels.back(), *q = nullptr;
+    slnode* p = levels.back(), *q = nullptr;
     if(Compare()(e, p->get_key())) return cbegin();
     if(p->get_key() == e) return cbegin();
 
@@ -592,49 +963,49 @@ typename skiplist<K, V, Compare, TRandom, MaxLevel>::const_iterator skiplist<K,
             while(p->get_down()) {
                 p = p->get_down();
             }
-            return const_iterator(p);
+            return const_iterator(*this, p);
         }
         q = p;
         p = p->get_down();
     }
-    return const_iterator(q->get_next());
+    return const_iterator(*this, q->get_next());
 }
 
-template<class K, class V, class Compare, typename TRandom, int MaxLevel>
-typename skiplist<K, V, Compare, TRandom, MaxLevel>::iterator skiplist<K, V, Compare, TRandom, MaxLevel>::upper_bound(const K& e) {
-    skiplist<K, V, Compare, TRandom, MaxLevel>::iterator it = lower_bound(e);
+template<class K, class V, class Compare, typename TRandom, int MaxLevel, class Monoid, bool Recency>
+typename skiplist<K, V, Compare, TRandom, MaxLevel, Monoid, Recency>::iterator skiplist<K, V, Compare, TRandom, MaxLevel, Monoid, Recency>::upper_bound(const K& e) {
+    skiplist<K, V, Compare, TRandom, MaxLevel, Monoid, Recency>::iterator it = lower_bound(e);
     if(it != end() && *it->first == e) {
         ++it;
     }
     return it;
 }
 
-template<class K, class V, class Compare, typename TRandom, int MaxLevel>
-typename skiplist<K, V, Compare, TRandom, MaxLevel>::const_iterator skiplist<K, V, Compare, TRandom, MaxLevel>::upper_bound(const K& e) const {
-    skiplist<K, V, Compare, TRandom, MaxLevel>::const_iterator it = lower_bound(e);
+template<class K, class V, class Compare, typename TRandom, int MaxLevel, class Monoid, bool Recency>
+typename skiplist<K, V, Compare, TRandom, MaxLevel, Monoid, Recency>::const_iterator skiplist<K, V, Compare, TRandom, MaxLevel, Monoid, Recency>::upper_bound(const K& e) const {
+    skiplist<K, V, Compare, TRandom, MaxLevel, Monoid, Recency>::const_iterator it = lower_bound(e);
     if(it != cend() && *it->first == e) {
         ++it;
     }
     return it;
 }
 
-template<class K, class V, class Compare, typename TRandom, int MaxLevel>
-V& skiplist<K, V, Compare, TRandom, MaxLevel>::operator[](const K& k) {
+template<class K, class V, class Compare, typename TRandom, int MaxLevel, class Monoid, bool Recency>
+typename skiplist<K, V, Compare, TRandom, MaxLevel, Monoid, Recency>::stored_value& skiplist<K, V, Compare, TRandom, MaxLevel, Monoid, Recency>::operator[](const K& k) {
     return *((insert(k, V())).first->second);
 }
 
-template<class K, class V, class Compare, typename TRandom, int MaxLevel>
-const V& skiplist<K, V, Compare, TRandom, MaxLevel>::at(const K& k) const {
+template<class K, class V, class Compare, typename TRandom, int MaxLevel, class Monoid, bool Recency>
+const V& skiplist<K, V, Compare, TRandom, MaxLevel, Monoid, Recency>::at(const K& k) const {
     auto it = find(k);
-    if(it == end()) {
+    if(it == cend()) {
         throw SLNodeException("Key doesn't exist in skiplist");
     } else {
         return *(it->second);
     }
 }
 
-template<class K, class V, class Compare, typename TRandom, int MaxLevel>
-V& skiplist<K, V, Compare, TRandom, MaxLevel>::at(const K& k) {
+template<class K, class V, class Compare, typename TRandom, int MaxLevel, class Monoid, bool Recency>
+typename skiplist<K, V, Compare, TRandom, MaxLevel, Monoid, Recency>::stored_value& skiplist<K, V, Compare, TRandom, MaxLevel, Monoid, Recency>::at(const K& k) {
     auto it = find(k);
     if(it == end()) {
         throw SLNodeException("Key doesn't exist in skiplist");
@@ -643,13 +1014,527 @@ V& skiplist<K, V, Compare, TRandom, MaxLevel>::at(const K& k) {
     }
 }
 
-template<class K, class V, class Compare, typename TRandom, int MaxLevel>
-void skiplist<K, V, Compare, TRandom, MaxLevel>::swap(skiplist<K, V, Compare, TRandom, MaxLevel>& sk) {
+template<class K, class V, class Compare, typename TRandom, int MaxLevel, class Monoid, bool Recency>
+void skiplist<K, V, Compare, TRandom, MaxLevel, Monoid, Recency>::swap(skiplist<K, V, Compare, TRandom, MaxLevel, Monoid, Recency>& sk) {
     std::swap(this->last, sk.last);
     std::swap(this->prob, sk.prob);
     std::swap(this->generator, sk.generator);
     std::swap(this->nb, sk.nb);
+    std::swap(this->nodes, sk.nodes);
+    std::swap(this->capacity, sk.capacity);
+    std::swap(this->byte_capacity, sk.byte_capacity);
+    std::swap(this->policy, sk.policy);
+    std::swap(this->recent, sk.recent);
+    std::swap(this->oldest, sk.oldest);
     this->levels.swap(sk.levels);
 }
 
+template<class K, class V, class Compare, typename TRandom, int MaxLevel, class Monoid, bool Recency>
+void skiplist<K, V, Compare, TRandom, MaxLevel, Monoid, Recency>::take(skiplist<K, V, Compare, TRandom, MaxLevel, Monoid, Recency>& sk) {
+    // moves the nodes of sk to this empty skiplist, leaving sk empty
+    this->levels.swap(sk.levels);
+    std::swap(this->last, sk.last);
+    std::swap(this->nb, sk.nb);
+    std::swap(this->nodes, sk.nodes);
+}
+
+template<class K, class V, class Compare, typename TRandom, int MaxLevel, class Monoid, bool Recency>
+void skiplist<K, V, Compare, TRandom, MaxLevel, Monoid, Recency>::split(const K& k, skiplist<K, V, Compare, TRandom, MaxLevel, Monoid, Recency>& tail) {
+    // moves the entries whose key is not less than k to the empty skiplist
+    // tail; towers are unlinked in place and only the head tower of tail is
+    // allocated, the counts cost a walk of the smaller part
+    if(policy != NO_EVICTION || tail.policy != NO_EVICTION) throw SkiplistException("Calling split method on a capacity-bounded skiplist");
+    if(! tail.empty()) throw SkiplistException("Calling split method with a non empty tail");
+    slnode* x = seek(k);
+    if(! x) return;
+    if(x == levels.front()) {
+        tail.take(*this);
+        return;
+    }
+
+    std::vector<slnode*> previous(MaxLevel, nullptr), first(MaxLevel, nullptr);
+    slnode* p = levels.back();
+    for(int i=MaxLevel - 1; i >= 0; i--) {
+        while(p->get_next() && Compare()(p->get_next()->get_key(), k)) {
+            p = p->get_next();
+        }
+        previous[i] = p;
+        p = p->get_down();
+    }
+
+    for(int i=0; i < MaxLevel; i++) {
+        first[i] = previous[i]->get_next();
+        previous[i]->set_next(nullptr);
+        if(first[i]) first[i]->set_prev(nullptr);
+    }
+    size_t moved = count_cut(first, 1, nb), moved_nodes = count_cut(first, MaxLevel, nodes);
+    tail.last = last;
+    last = previous[0];
+    nb -= moved;
+    nodes -= moved_nodes;
+    tail.nb = moved;
+    tail.nodes = moved_nodes;
+
+    // above its own tower, x gets head nodes linked to the first node each
+    // level kept after the cut
+    int i = 0;
+    tail.levels[0] = x;
+    while(tail.levels[i]->get_up()) {
+        tail.levels[i + 1] = tail.levels[i]->get_up();
+        i++;
+    }
+    for(i++; i < MaxLevel; i++) {
+        tail.levels[i] = tail.make_node(x->get_key_value().first, x->get_key_value().second, first[i], nullptr, nullptr, tail.levels[i-1]);
+        if(first[i]) first[i]->set_prev(tail.levels[i]);
+        tail.levels[i-1]->set_up(tail.levels[i]);
+    }
+    refresh_path(last);
+    tail.refresh_path(x);
+}
+
+template<class K, class V, class Compare, typename TRandom, int MaxLevel, class Monoid, bool Recency>
+size_t skiplist<K, V, Compare, TRandom, MaxLevel, Monoid, Recency>::count_cut(const std::vector<slnode*>& cut, int height, size_t total) const {
+    // counts the nodes on the first height levels of the lists starting at
+    // cut, out of total nodes shared with the levels still in this skiplist;
+    // both sides are walked in step and the first to end gives the answer
+    int i = 0, j = 0;
+    const slnode* p = levels[0];
+    const slnode* q = cut[0];
+    size_t kept = 0, moved = 0;
+    while(true) {
+        while(! p && ++i < height) p = levels[i];
+        if(! p) return total - kept;
+        while(! q && ++j < height) q = cut[j];
+        if(! q) return moved;
+        p = p->get_next();
+        q = q->get_next();
+        kept++;
+        moved++;
+    }
+}
+
+template<class K, class V, class Compare, typename TRandom, int MaxLevel, class Monoid, bool Recency>
+void skiplist<K, V, Compare, TRandom, MaxLevel, Monoid, Recency>::append(skiplist<K, V, Compare, TRandom, MaxLevel, Monoid, Recency>& sk) {
+    // moves every entry of sk, whose keys must all be greater than the keys
+    // of this skiplist, to its end in O(MaxLevel): the head tower of sk is cut
+    // down to a random height and the rest is relinked as is
+    if(policy != NO_EVICTION || sk.policy != NO_EVICTION) throw SkiplistException("Calling append method on a capacity-bounded skiplist");
+    if(sk.empty()) return;
+    if(empty()) {
+        take(sk);
+        return;
+    }
+    if(! Compare()(last->get_key(), sk.levels.front()->get_key())) throw SkiplistException("Calling append method with keys not greater than the skiplist ones");
+
+    std::vector<slnode*> previous(MaxLevel, nullptr);
+    slnode* p = levels.back();
+    for(int i=MaxLevel - 1; i >= 0; i--) {
+        while(p->get_next()) {
+            p = p->get_next();
+        }
+        previous[i] = p;
+        p = p->get_down();
+    }
+
+    int h = 1;
+    while(h < MaxLevel && generator() < (generator.max() + generator.min()) * this->prob) {
+        h++;
+    }
+    for(int i=0; i < MaxLevel; i++) {
+        slnode* q = sk.levels[i];
+        if(i >= h) {
+            q = q->get_next();
+            sk.drop_node(sk.levels[i]);
+        }
+        previous[i]->set_next(q);
+        if(q) q->set_prev(previous[i]);
+        sk.levels[i] = nullptr;
+    }
+    if(h < MaxLevel) previous[h-1]->get_next()->set_up(nullptr);
+
+    slnode* joint = last;
+    last = sk.last;
+    nb += sk.nb;
+    nodes += sk.nodes;
+    sk.last = nullptr;
+    sk.nb = 0;
+    sk.nodes = 0;
+    refresh_path(joint);
+}
+
+template<class K, class V, class Compare, typename TRandom, int MaxLevel, class Monoid, bool Recency>
+void skiplist<K, V, Compare, TRandom, MaxLevel, Monoid, Recency>::check_invariants() const {
+    // walks every level and throws SkiplistException at the first broken link
+    if(levels.size() != MaxLevel) throw SkiplistException("Wrong number of levels");
+    if(empty()) {
+        for(int i=0; i < MaxLevel; i++) {
+            if(levels[i]) throw SkiplistException("Empty skiplist with a non empty level");
+        }
+        if(nodes != 0) throw SkiplistException("Empty skiplist still owning nodes");
+        if(recent || oldest) throw SkiplistException("Empty skiplist with a non empty recency list");
+        return;
+    }
+
+    size_t count = 0;
+    for(int i=0; i < MaxLevel; i++) {
+        slnode* p = levels[i];
+        if(! p) throw SkiplistException("Head tower shorter than MaxLevel");
+        if(p->get_prev()) throw SkiplistException("Head node with a predecessor");
+        if(p->get_key_value() != levels.front()->get_key_value()) throw SkiplistException("Head tower holding several keys");
+        if(i > 0 && p->get_down() != levels[i-1]) throw SkiplistException("Head tower not linked downwards");
+        if(i + 1 < MaxLevel && p->get_up() != levels[i+1]) throw SkiplistException("Head tower not linked upwards");
+        if(i + 1 == MaxLevel && p->get_up()) throw SkiplistException("Node above the top level");
+
+        for(; p; p = p->get_next()) {
+            count++;
+            if(p->get_next() && p->get_next()->get_prev() != p) throw SkiplistException("Broken prev link");
+            if(p->get_next() && ! Compare()(p->get_key(), p->get_next()->get_key())) throw SkiplistException("Keys out of order");
+            if(i == 0 && p->get_down()) throw SkiplistException("Node below level 0");
+            if(i > 0 && (! p->get_down() || p->get_down()->get_up() != p)) throw SkiplistException("Broken down link");
+            if(i > 0 && p->get_down()->get_key_value() != p->get_key_value()) throw SkiplistException("Tower holding several keys");
+            if(p->get_up() && p->get_up()->get_down() != p) throw SkiplistException("Broken up link");
+            if(i == 0 && ! p->get_next() && p != last) throw SkiplistException("Last does not point to the last node");
+            if constexpr (Recency) {
+                if(i > 0 && (p->get_newer() || p->get_older())) throw SkiplistException("Upper node in the recency list");
+            }
+
+            if constexpr (! std::is_void<Monoid>::value) {
+                aggregate_type acc = Monoid::identity();
+                if(! p->get_down()) {
+                    acc = Monoid::lift(p->get_value());
+                } else {
+                    slnode* stop = p->get_next()? p->get_next()->get_down() : nullptr;
+                    for(slnode* q = p->get_down(); q != stop; q = q->get_next()) {
+                        acc = Monoid::combine(acc, q->get_aggregate());
+                    }
+                }
+                if(! (acc == p->get_aggregate())) throw SkiplistException("Stale aggregate");
+            }
+        }
+        if(i == 0 && count != nb) throw SkiplistException("Size does not match level 0");
+    }
+    if(count != nodes) throw SkiplistException("Node count does not match the levels");
+
+    if constexpr (Recency) {
+        if(policy == EVICT_LRU) {
+            size_t n = 0;
+            for(slnode* p = recent; p; p = p->get_older(), n++) {
+                if(n >= nb) throw SkiplistException("Recency list longer than the skiplist");
+                if(p->get_older() && p->get_older()->get_newer() != p) throw SkiplistException("Broken recency link");
+                if(! p->get_older() && p != oldest) throw SkiplistException("Oldest does not end the recency list");
+            }
+            if(n != nb) throw SkiplistException("Recency list shorter than the skiplist");
+        }
+    }
+    if(policy != NO_EVICTION && nb > 1 && over_budget()) throw SkiplistException("Skiplist over its budget");
+}
+
+template<class K, class V, class Compare, typename TRandom, int MaxLevel, class Monoid, bool Recency>
+void skiplist<K, V, Compare, TRandom, MaxLevel, Monoid, Recency>::set_capacity(size_t entries, size_t bytes, eviction_policy policy) {
+    // 0 leaves the corresponding bound unset
+    if constexpr (Recency) {
+        if(policy == EVICT_LRU && this->policy != EVICT_LRU) {
+            recent = oldest = nullptr;
+            for(slnode* p = levels.front(); p; p = p->get_next()) {
+                p->set_newer(oldest);
+                p->set_older(nullptr);
+                if(oldest) oldest->set_older(p);
+                else recent = p;
+                oldest = p;
+            }
+        } else if(policy != EVICT_LRU) {
+            recent = oldest = nullptr;
+        }
+    } else if(policy == EVICT_LRU) {
+        throw SkiplistException("EVICT_LRU needs the recency links of an lru_skiplist");
+    }
+    this->policy = policy;
+    capacity = entries;
+    byte_capacity = bytes;
+    evict(nullptr);
+}
+
+template<class K, class V, class Compare, typename TRandom, int MaxLevel, class Monoid, bool Recency>
+void skiplist<K, V, Compare, TRandom, MaxLevel, Monoid, Recency>::touch(slnode* x) {
+    // moves the level 0 node x to the front of the recency list
+    if constexpr (Recency) {
+        if(policy != EVICT_LRU || x == recent) return;
+        forget(x);
+        x->set_older(recent);
+        if(recent) recent->set_newer(x);
+        recent = x;
+        if(! oldest) oldest = x;
+    }
+}
+
+template<class K, class V, class Compare, typename TRandom, int MaxLevel, class Monoid, bool Recency>
+void skiplist<K, V, Compare, TRandom, MaxLevel, Monoid, Recency>::forget(slnode* x) {
+    if constexpr (Recency) {
+        if(policy != EVICT_LRU) return;
+        if(x->get_newer()) x->get_newer()->set_older(x->get_older());
+        else if(recent == x) recent = x->get_older();
+        if(x->get_older()) x->get_older()->set_newer(x->get_newer());
+        else if(oldest == x) oldest = x->get_newer();
+        x->set_newer(nullptr);
+        x->set_older(nullptr);
+    }
+}
+
+template<class K, class V, class Compare, typename TRandom, int MaxLevel, class Monoid, bool Recency>
+bool skiplist<K, V, Compare, TRandom, MaxLevel, Monoid, Recency>::over_budget() const {
+    return (capacity && nb > capacity) || (byte_capacity && memory_usage() > byte_capacity);
+}
+
+template<class K, class V, class Compare, typename TRandom, int MaxLevel, class Monoid, bool Recency>
+void skiplist<K, V, Compare, TRandom, MaxLevel, Monoid, Recency>::evict(const slnode* keep) {
+    // erases entries chosen by the policy until the list fits its budget again,
+    // never the entry keep which has just been inserted nor the last one left
+    while(policy != NO_EVICTION && nb > 1 && over_budget()) {
+        slnode* victim = nullptr;
+        switch(policy) {
+        case EVICT_SMALLEST:
+            victim = (levels.front() != keep)? levels.front() : levels.front()->get_next();
+            break;
+        case EVICT_LARGEST:
+            victim = (last != keep)? last : last->get_prev();
+            break;
+        case EVICT_LRU:
+            if constexpr (Recency) {
+                victim = (oldest != keep)? oldest : oldest->get_newer();
+            }
+            break;
+        default:
+            break;
+        }
+        if(! victim) return;
+        erase(iterator(*this, victim));
+    }
+}
+
+template<class K, class V, class Compare, typename TRandom, int MaxLevel, class Monoid, bool Recency>
+typename skiplist<K, V, Compare, TRandom, MaxLevel, Monoid, Recency>::slnode* skiplist<K, V, Compare, TRandom, MaxLevel, Monoid, Recency>::seek(const K& e) const {
+    // first node of level 0 whose key is not less than e
+    if(empty()) return nullptr;
+    slnode* p = levels.back();
+    if(! Compare()(p->get_key(), e)) return levels.front();
+
+    while(true) {
+        while(p->get_next() && Compare()(p->get_next()->get_key(), e)) {
+            p = p->get_next();
+        }
+        if(! p->get_down()) return p->get_next();
+        p = p->get_down();
+    }
+}
+
+template<class K, class V, class Compare, typename TRandom, int MaxLevel, class Monoid, bool Recency>
+std::vector<typename skiplist<K, V, Compare, TRandom, MaxLevel, Monoid, Recency>::slnode*> skiplist<K, V, Compare, TRandom, MaxLevel, Monoid, Recency>::partition(slnode* first, slnode* stop, unsigned int chunks) const {
+    // splits the level 0 run [first, stop) at the nodes of the highest level
+    // holding at least chunks-1 nodes inside the run, so that chunks are balanced
+    std::vector<slnode*> bounds(1, first);
+    if(first && first != stop && chunks > 1) {
+        std::vector<slnode*> lane;
+        slnode* p = levels.back();
+        for(int i=MaxLevel - 1; i > 0 && lane.size() + 1 < chunks; i--) {
+            while(p->get_next() && ! Compare()(first->get_key(), p->get_next()->get_key())) {
+                p = p->get_next();
+            }
+            lane.clear();
+            for(slnode* q = p->get_next(); q && (! stop || Compare()(q->get_key(), stop->get_key())); q = q->get_next()) {
+                lane.push_back(q);
+            }
+            p = p->get_down();
+        }
+
+        size_t n = std::min<size_t>(lane.size(), chunks - 1);
+        for(size_t j=1; j <= n; j++) {
+            slnode* q = lane[(j * lane.size()) / (n + 1)];
+            while(q->get_down()) {
+                q = q->get_down();
+            }
+            bounds.push_back(q);
+        }
+    }
+    bounds.push_back(stop);
+    return bounds;
+}
+
+template<class K, class V, class Compare, typename TRandom, int MaxLevel, class Monoid, bool Recency>
+template <class Function>
+void skiplist<K, V, Compare, TRandom, MaxLevel, Monoid, Recency>::for_each_chunk(slnode* first, slnode* stop, Function& fn, unsigned int threads) const {
+    std::vector<slnode*> bounds = partition(first, stop, std::max(threads, 1u));
+    std::vector<std::future<void>> jobs;
+    for(size_t j=0; j + 1 < bounds.size(); j++) {
+        jobs.push_back(std::async(std::launch::async, [&fn](slnode* p, slnode* end) {
+            for(; p != end; p = p->get_next()) {
+                fn(p->get_key_value());
+            }
+        }, bounds[j], bounds[j+1]));
+    }
+    for(auto& job: jobs) {
+        job.get();
+    }
+}
+
+template<class K, class V, class Compare, typename TRandom, int MaxLevel, class Monoid, bool Recency>
+template <class T, class Accumulate, class Combine>
+T skiplist<K, V, Compare, TRandom, MaxLevel, Monoid, Recency>::reduce_chunks(slnode* first, slnode* stop, const T& identity, Accumulate& acc, Combine& combine, unsigned int threads) const {
+    std::vector<slnode*> bounds = partition(first, stop, std::max(threads, 1u));
+    std::vector<std::future<T>> jobs;
+    for(size_t j=0; j + 1 < bounds.size(); j++) {
+        jobs.push_back(std::async(std::launch::async, [&acc, &identity](slnode* p, slnode* end) {
+            T partial = identity;
+            for(; p != end; p = p->get_next()) {
+                partial = acc(partial, p->get_key_value());
+            }
+            return partial;
+        }, bounds[j], bounds[j+1]));
+    }
+
+    // partial results are combined in key order whatever the completion order
+    T result = identity;
+    for(auto& job: jobs) {
+        result = combine(result, job.get());
+    }
+    return result;
+}
+
+template<class K, class V, class Compare, typename TRandom, int MaxLevel, class Monoid, bool Recency>
+template <class Function>
+void skiplist<K, V, Compare, TRandom, MaxLevel, Monoid, Recency>::parallel_for_each(const K& lo, const K& hi, Function fn, unsigned int threads) const {
+    slnode* first = seek(lo), *stop = seek(hi);
+    if(! first || (stop && ! Compare()(first->get_key(), stop->get_key()))) return;
+    for_each_chunk(first, stop, fn, threads);
+}
+
+template<class K, class V, class Compare, typename TRandom, int MaxLevel, class Monoid, bool Recency>
+template <class Function>
+void skiplist<K, V, Compare, TRandom, MaxLevel, Monoid, Recency>::parallel_for_each(Function fn, unsigned int threads) const {
+    if(empty()) return;
+    for_each_chunk(levels.front(), nullptr, fn, threads);
+}
+
+template<class K, class V, class Compare, typename TRandom, int MaxLevel, class Monoid, bool Recency>
+template <class T, class Accumulate, class Combine>
+T skiplist<K, V, Compare, TRandom, MaxLevel, Monoid, Recency>::parallel_reduce(const K& lo, const K& hi, T identity, Accumulate acc, Combine combine, unsigned int threads) const {
+    slnode* first = seek(lo), *stop = seek(hi);
+    if(! first || (stop && ! Compare()(first->get_key(), stop->get_key()))) return identity;
+    return reduce_chunks(first, stop, identity, acc, combine, threads);
+}
+
+template<class K, class V, class Compare, typename TRandom, int MaxLevel, class Monoid, bool Recency>
+template <class T, class Accumulate, class Combine>
+T skiplist<K, V, Compare, TRandom, MaxLevel, Monoid, Recency>::parallel_reduce(T identity, Accumulate acc, Combine combine, unsigned int threads) const {
+    if(empty()) return identity;
+    return reduce_chunks(levels.front(), nullptr, identity, acc, combine, threads);
+}
+
+template<class K, class V, class Compare, typename TRandom, int MaxLevel, class Monoid, bool Recency>
+void skiplist<K, V, Compare, TRandom, MaxLevel, Monoid, Recency>::refresh(slnode* x) {
+    // a node of level 0 holds its own value, a node of upper level i holds the
+    // aggregate of the level i-1 nodes it skips, up to the next node of level i
+    if constexpr (! std::is_void<Monoid>::value) {
+        if(! x->get_down()) {
+            x->set_aggregate(Monoid::lift(x->get_value()));
+            return;
+        }
+        slnode* stop = x->get_next()? x->get_next()->get_down() : nullptr;
+        aggregate_type acc = Monoid::identity();
+        for(slnode* q = x->get_down(); q != stop; q = q->get_next()) {
+            acc = Monoid::combine(acc, q->get_aggregate());
+        }
+        x->set_aggregate(acc);
+    }
+}
+
+template<class K, class V, class Compare, typename TRandom, int MaxLevel, class Monoid, bool Recency>
+void skiplist<K, V, Compare, TRandom, MaxLevel, Monoid, Recency>::refresh_path(slnode* a, slnode* b) {
+    // refreshes, level by level from the bottom, the nodes whose span covers
+    // the level 0 nodes a and b
+    if constexpr (! std::is_void<Monoid>::value) {
+        for(int i=0; i < MaxLevel; i++) {
+            refresh(a);
+            if(b && b != a) refresh(b);
+            if(i + 1 == MaxLevel) break;
+
+            while(! a->get_up()) a = a->get_prev();
+            a = a->get_up();
+            if(b) {
+                while(! b->get_up()) b = b->get_prev();
+                b = b->get_up();
+            }
+        }
+    }
+}
+
+template<class K, class V, class Compare, typename TRandom, int MaxLevel, class Monoid, bool Recency>
+bool skiplist<K, V, Compare, TRandom, MaxLevel, Monoid, Recency>::covered(const slnode* x, const K& hi) const {
+    // true if every key spanned by x is less than hi
+    if(x->get_next()) return ! Compare()(hi, x->get_next()->get_key());
+    return Compare()(last->get_key(), hi);
+}
+
+template<class K, class V, class Compare, typename TRandom, int MaxLevel, class Monoid, bool Recency>
+typename skiplist<K, V, Compare, TRandom, MaxLevel, Monoid, Recency>::aggregate_type skiplist<K, V, Compare, TRandom, MaxLevel, Monoid, Recency>::aggregate(const K& lo, const K& hi) const {
+    static_assert(! std::is_void<Monoid>::value, "aggregate requires an augmented skiplist");
+    aggregate_type acc = Monoid::identity();
+    slnode* p = seek(lo);
+    while(p && Compare()(p->get_key(), hi)) {
+        while(p->get_up() && covered(p->get_up(), hi)) {
+            p = p->get_up();
+        }
+        acc = Monoid::combine(acc, p->get_aggregate());
+        p = p->get_next();
+        while(p && p->get_down() && ! covered(p, hi)) {
+            p = p->get_down();
+        }
+    }
+    return acc;
+}
+
+template<class K, class V, class Compare, typename TRandom, int MaxLevel, class Monoid, bool Recency>
+typename skiplist<K, V, Compare, TRandom, MaxLevel, Monoid, Recency>::aggregate_type skiplist<K, V, Compare, TRandom, MaxLevel, Monoid, Recency>::aggregate() const {
+    static_assert(! std::is_void<Monoid>::value, "aggregate requires an augmented skiplist");
+    aggregate_type acc = Monoid::identity();
+    for(slnode* p = levels.back(); p; p = p->get_next()) {
+        acc = Monoid::combine(acc, p->get_aggregate());
+    }
+    return acc;
+}
+
+template<class K, class V, class Compare, typename TRandom, int MaxLevel, class Monoid, bool Recency>
+typename skiplist<K, V, Compare, TRandom, MaxLevel, Monoid, Recency>::cursor skiplist<K, V, Compare, TRandom, MaxLevel, Monoid, Recency>::cursor_at(const K& lo, unsigned int distance) {
+    return cursor(seek(lo), nullptr, distance);
+}
+
+template<class K, class V, class Compare, typename TRandom, int MaxLevel, class Monoid, bool Recency>
+typename skiplist<K, V, Compare, TRandom, MaxLevel, Monoid, Recency>::const_cursor skiplist<K, V, Compare, TRandom, MaxLevel, Monoid, Recency>::cursor_at(const K& lo, unsigned int distance) const {
+    return const_cursor(seek(lo), nullptr, distance);
+}
+
+template<class K, class V, class Compare, typename TRandom, int MaxLevel, class Monoid, bool Recency>
+typename skiplist<K, V, Compare, TRandom, MaxLevel, Monoid, Recency>::range_view skiplist<K, V, Compare, TRandom, MaxLevel, Monoid, Recency>::range(const K& lo, const K& hi, unsigned int distance) {
+    slnode* first = seek(lo), *stop = seek(hi);
+    if(stop && stop->get_key() == hi) stop = stop->get_next();
+    if(! first || (stop && Compare()(stop->get_key(), first->get_key()))) return range_view();
+    return range_view(first, stop, distance);
+}
+
+template<class K, class V, class Compare, typename TRandom, int MaxLevel, class Monoid, bool Recency>
+typename skiplist<K, V, Compare, TRandom, MaxLevel, Monoid, Recency>::const_range_view skiplist<K, V, Compare, TRandom, MaxLevel, Monoid, Recency>::range(const K& lo, const K& hi, unsigned int distance) const {
+    slnode* first = seek(lo), *stop = seek(hi);
+    if(stop && stop->get_key() == hi) stop = stop->get_next();
+    if(! first || (stop && Compare()(stop->get_key(), first->get_key()))) return const_range_view();
+    return const_range_view(first, stop, distance);
+}
+
+
+template<class K, class V, class Monoid, class Compare=std::less<K>, typename TRandom=std::default_random_engine, int MaxLevel=10>
+using augmented_skiplist = skiplist<K, V, Compare, TRandom, MaxLevel, Monoid>;
+
+// nodes carry the links of the recency list EVICT_LRU needs, other
+// skiplists keep the smaller node layout
+template<class K, class V, class Compare=std::less<K>, typename TRandom=std::default_random_engine, int MaxLevel=10, class Monoid=void>
+using lru_skiplist = skiplist<K, V, Compare, TRandom, MaxLevel, Monoid, true>;
+
 #endif // SKIPLIST_H
\ No newline at end of file
@@ -0,0 +1,79 @@
+#ifndef SKIPLIST_CODECS_H
+#define SKIPLIST_CODECS_H
+
+#include <string>
+#include <limits>
+#include <cstdint>
+#include <algorithm>
+#include <type_traits>
+#include "skiplist_exceptions.hpp"
+
+// A codec given to a compressed skiplist provides:
+//   encoded_type                    what a level 0 node stores instead of its key
+//   encode(prev, key)               key encoded against its predecessor prev, may throw
+//                                   SkiplistException in which case the node keeps the full key
+//   decode(key, e)                  turns the predecessor key into the encoded one, in place
+//   heap_size(e)                    bytes owned by e outside of the node
+
+template<class K>
+struct plain_codec {
+    typedef K encoded_type;
+    static encoded_type encode(const K&, const K& key) { return key; }
+    static void decode(K& key, const encoded_type& e) { key = e; }
+    static size_t heap_size(const encoded_type&) { return 0; }
+};
+
+// front coding: length of the prefix shared with the predecessor, then the rest
+struct front_codec {
+    struct encoded_type {
+        uint32_t shared;
+        std::string suffix;
+    };
+
+    static encoded_type encode(const std::string& prev, const std::string& key) {
+        size_t n = 0, max = std::min<size_t>(std::min(prev.size(), key.size()), std::numeric_limits<uint32_t>::max());
+        while(n < max && prev[n] == key[n]) {
+            n++;
+        }
+        return { static_cast<uint32_t>(n), key.substr(n) };
+    }
+    static void decode(std::string& key, const encoded_type& e) {
+        key.resize(e.shared);
+        key += e.suffix;
+    }
+    static size_t heap_size(const encoded_type& e) {
+        return (e.suffix.capacity() > std::string().capacity())? e.suffix.capacity() + 1 : 0;
+    }
+};
+
+// delta coding of increasing integer keys, gaps that D cannot hold are stored as full keys;
+// gaps are computed in the unsigned type of K, where they cannot overflow
+template<class K, class D>
+struct delta_codec {
+    typedef D encoded_type;
+    typedef typename std::make_unsigned<K>::type gap_type;
+    typedef typename std::common_type<gap_type, typename std::make_unsigned<D>::type>::type wide_type;
+
+    static encoded_type encode(const K& prev, const K& key) {
+        if(key < prev) throw SkiplistException("Key delta does not fit the codec");
+        gap_type gap = static_cast<gap_type>(static_cast<gap_type>(key) - static_cast<gap_type>(prev));
+        if(static_cast<wide_type>(gap) > static_cast<wide_type>(std::numeric_limits<D>::max())) throw SkiplistException("Key delta does not fit the codec");
+        return static_cast<D>(gap);
+    }
+    static void decode(K& key, const encoded_type& e) {
+        key = static_cast<K>(static_cast<gap_type>(static_cast<gap_type>(key) + static_cast<gap_type>(e)));
+    }
+    static size_t heap_size(const encoded_type&) { return 0; }
+};
+
+template<class K>
+struct default_codec {
+    typedef plain_codec<K> type;
+};
+
+template<>
+struct default_codec<std::string> {
+    typedef front_codec type;
+};
+
+#endif // SKIPLIST_CODECS_H
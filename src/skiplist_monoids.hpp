@@ -0,0 +1,57 @@
+#ifndef SKIPLIST_MONOIDS_H
+#define SKIPLIST_MONOIDS_H
+
+#include <cstddef>
+#include <limits>
+#include <algorithm>
+
+// A monoid given to an augmented skiplist provides:
+//   value_type                      the aggregate type
+//   identity()                      the neutral element of combine
+//   lift(v)                         the aggregate of a single value
+//   combine(a, b)                   an associative merge, a coming first in key order
+
+template<class Monoid>
+struct skiplist_aggregate {
+    typedef typename Monoid::value_type type;
+};
+
+template<>
+struct skiplist_aggregate<void> {
+    typedef void type;
+};
+
+
+template<class V>
+struct count_monoid {
+    typedef size_t value_type;
+    static value_type identity() { return 0; }
+    static value_type lift(const V&) { return 1; }
+    static value_type combine(const value_type& a, const value_type& b) { return a + b; }
+};
+
+template<class V>
+struct sum_monoid {
+    typedef V value_type;
+    static value_type identity() { return V(); }
+    static value_type lift(const V& v) { return v; }
+    static value_type combine(const value_type& a, const value_type& b) { return a + b; }
+};
+
+template<class V>
+struct min_monoid {
+    typedef V value_type;
+    static value_type identity() { return std::numeric_limits<V>::max(); }
+    static value_type lift(const V& v) { return v; }
+    static value_type combine(const value_type& a, const value_type& b) { return std::min(a, b); }
+};
+
+template<class V>
+struct max_monoid {
+    typedef V value_type;
+    static value_type identity() { return std::numeric_limits<V>::lowest(); }
+    static value_type lift(const V& v) { return v; }
+    static value_type combine(const value_type& a, const value_type& b) { return std::max(a, b); }
+};
+
+#endif // SKIPLIST_MONOIDS_H
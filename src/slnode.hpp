@@ -5,31 +5,63 @@
 #include <ostream>
 #include "skiplist_exceptions.hpp"
 
-template<class T, class U, class Compare, typename TRandom, int MaxLevel>
+template<class T, class U, class Compare, typename TRandom, int MaxLevel, class Monoid, bool Recency>
 class skiplist;
 
 
+template<class A>
+class SLAggregate {
+    A agg;
 
-template<class K, class V> 
-class SLNode {
-    typedef std::pair<const K* const, V* const> value_type;
+public:
+    SLAggregate(): agg() {}
+    const A& get_aggregate() const { return agg; }
+    void set_aggregate(const A& agg) { this->agg=agg; }
+};
+
+template<>
+class SLAggregate<void> {};
+
+
+// recency list of level 0 nodes, only nodes of skiplists able to evict with
+// EVICT_LRU carry the links
+template<class N, bool R>
+class SLRecency {
+    N* newer;
+    N* older;
+
+public:
+    SLRecency(): newer(nullptr), older(nullptr) {}
+    N* get_newer() const { return newer; }
+    N* get_older() const { return older; }
+    void set_newer(N* newer) { this->newer=newer; }
+    void set_older(N* older) { this->older=older; }
+};
+
+template<class N>
+class SLRecency<N, false> {};
+
+
+template<class K, class V, class A=void, bool R=false> 
+class SLNode : public SLAggregate<A>, public SLRecency<SLNode<K, V, A, R>, R> {
+    typedef std::pair<const K*, V*> value_type;
 
     value_type kv;
-    SLNode<K, V>* next;
-    SLNode<K, V>* prev;
-    SLNode<K, V>* up;
-    SLNode<K, V>* down;
+    SLNode<K, V, A, R>* next;
+    SLNode<K, V, A, R>* prev;
+    SLNode<K, V, A, R>* up;
+    SLNode<K, V, A, R>* down;
 
 public:
-    SLNode(const K* key, V* value, SLNode<K, V>* next=nullptr, SLNode<K, V>* prev=nullptr, SLNode<K, V>* up=nullptr, SLNode<K, V>* down=nullptr): 
+    SLNode(const K* key, V* value, SLNode<K, V, A, R>* next=nullptr, SLNode<K, V, A, R>* prev=nullptr, SLNode<K, V, A, R>* up=nullptr, SLNode<K, V, A, R>* down=nullptr): 
             kv(std::make_pair(key, value)), next(next), prev(prev), up(up), down(down) {
                 if(! key) throw SLNodeException("Impossible to set key to nullptr");
             }
     
-    SLNode<K, V>* get_up() const { return up; }
-    SLNode<K, V>* get_down() const { return down; }
-    SLNode<K, V>* get_next() const { return next; }
-    SLNode<K, V>* get_prev() const { return prev; }
+    SLNode<K, V, A, R>* get_up() const { return up; }
+    SLNode<K, V, A, R>* get_down() const { return down; }
+    SLNode<K, V, A, R>* get_next() const { return next; }
+    SLNode<K, V, A, R>* get_prev() const { return prev; }
     const K& get_key() const { 
         if(! kv.first) throw SLNodeException("Impossible to get key from empty SLNode");
         return *(kv.first); 
@@ -40,20 +72,24 @@ public:
     }
     const value_type& get_key_value() const { return kv; };
 
-    void set_up(SLNode<K, V>* up) { this->up=up; }
-    void set_down(SLNode<K, V>* down) { this->down=down; }
-    void set_next(SLNode<K, V>* next) { this-> next=next; }
-    void set_prev(SLNode<K, V>* prev) { this->prev=prev; }
+    void set_up(SLNode<K, V, A, R>* up) { this->up=up; }
+    void set_down(SLNode<K, V, A, R>* down) { this->down=down; }
+    void set_next(SLNode<K, V, A, R>* next) { this-> next=next; }
+    void set_prev(SLNode<K, V, A, R>* prev) { this->prev=prev; }
+    void set_key_value(const K* key, V* value) { 
+        if(! key) throw SLNodeException("Impossible to set key to nullptr");
+        kv = std::make_pair(key, value);
+    }
     
-    template<class T, class U, class Compare, typename TRandom, int MaxLevel>
-    friend void skiplist<T, U, Compare, TRandom, MaxLevel>::erase(typename skiplist<T, U, Compare, TRandom, MaxLevel>::iterator it);
+    template<class T, class U, class Compare, typename TRandom, int MaxLevel, class Monoid, bool Recency>
+    friend void skiplist<T, U, Compare, TRandom, MaxLevel, Monoid, Recency>::erase(typename skiplist<T, U, Compare, TRandom, MaxLevel, Monoid, Recency>::iterator it);
 
-    template<class T, class U, class Compare, typename TRandom, int MaxLevel>
-    friend void skiplist<T, U, Compare, TRandom, MaxLevel>::clear();
+    template<class T, class U, class Compare, typename TRandom, int MaxLevel, class Monoid, bool Recency>
+    friend void skiplist<T, U, Compare, TRandom, MaxLevel, Monoid, Recency>::clear();
 };
 
-template<class K, class V> 
-std::ostream& operator<< (std::ostream& out, const SLNode<K, V>& n) {
+template<class K, class V, class A, bool R> 
+std::ostream& operator<< (std::ostream& out, const SLNode<K, V, A, R>& n) {
     out << "<" << n.get_key() << ", " << n.get_value() << ">";
     return out;
 }
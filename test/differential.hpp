@@ -0,0 +1,610 @@
+#ifndef SKIPLIST_DIFFERENTIAL_H
+#define SKIPLIST_DIFFERENTIAL_H
+
+// Differential harness: decodes a byte string into a sequence of operations,
+// applies it to the containers of src/ and to a std::map model, and aborts on
+// the first difference or broken invariant. Shared by the randomized driver
+// and the libFuzzer entry point.
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstdint>
+#include <string>
+#include <limits>
+#include <numeric>
+#include <map>
+#include <list>
+#include <vector>
+#include <atomic>
+#include <random>
+#include <type_traits>
+#include "../src/skiplist.hpp"
+#include "../src/compressed_skiplist.hpp"
+#include "../src/sharded_skiplist.hpp"
+
+#define CHECK(cond) do { \
+        if(! (cond)) { \
+            std::fprintf(stderr, "%s:%d: check failed: %s\n", __FILE__, __LINE__, #cond); \
+            std::abort(); \
+        } \
+    } while(0)
+
+#define CHECK_THROWS(expr, exception) do { \
+        bool thrown = false; \
+        try { expr; } catch(exception&) { thrown = true; } \
+        CHECK(thrown); \
+    } while(0)
+
+
+// skiplists seed their generator from the clock, this engine ignores that
+// seed so that a given input always builds the same towers
+struct replay_engine : public std::minstd_rand {
+    replay_engine(unsigned long=0): std::minstd_rand(++seed()) {}
+    static unsigned long& seed() { static unsigned long s = 0; return s; }
+};
+
+
+class op_stream {
+    const uint8_t* data;
+    size_t size;
+    size_t pos;
+
+public:
+    op_stream(const uint8_t* data, size_t size): data(data), size(size), pos(0) {}
+    bool done() const { return pos >= size; }
+    uint8_t next() { return (pos < size)? data[pos++] : 0; }
+    int key() { return static_cast<int>(next() % 81) - 40; }
+    long value() { return next(); }
+};
+
+
+// std::map plus the recency list and eviction rules a bounded skiplist follows;
+// bytes are counted as memory_usage() does for towers of a single node, the
+// head tower aside, which is what a skiplist built with probability 0 has
+struct model {
+    std::map<int, long> m;
+    std::list<int> recency;
+    eviction_policy policy;
+    size_t capacity;
+    size_t bytes;
+    size_t node_size;
+    size_t head_nodes;
+
+    model(eviction_policy policy, size_t capacity, size_t bytes=0, size_t node_size=0, size_t head_nodes=0):
+            policy(policy), capacity(capacity), bytes(bytes), node_size(node_size), head_nodes(head_nodes) {}
+
+    size_t usage() const { return m.empty()? 0 : (m.size() + head_nodes) * node_size + m.size() * (sizeof(int) + sizeof(long)); }
+    bool over_budget() const { return (capacity && m.size() > capacity) || (bytes && usage() > bytes); }
+
+    void touch(int k) {
+        if(policy != EVICT_LRU || ! m.count(k)) return;
+        recency.remove(k);
+        recency.push_front(k);
+    }
+    void added(int k) {
+        touch(k);
+        // the entry just added stays even when it alone is over the budget
+        while(policy != NO_EVICTION && m.size() > 1 && over_budget()) {
+            int victim = 0;
+            switch(policy) {
+            case EVICT_SMALLEST:
+                victim = (m.begin()->first != k)? m.begin()->first : std::next(m.begin())->first;
+                break;
+            case EVICT_LARGEST:
+                victim = (m.rbegin()->first != k)? m.rbegin()->first : std::next(m.rbegin())->first;
+                break;
+            default:
+                victim = (recency.back() != k)? recency.back() : *std::next(recency.rbegin());
+                break;
+            }
+            removed(victim);
+        }
+    }
+    void removed(int k) {
+        m.erase(k);
+        recency.remove(k);
+    }
+};
+
+
+// node type and height of the head tower of a skiplist, as memory_usage()
+// counts them
+template<class SL>
+struct list_layout;
+
+template<class K, class V, class Compare, typename TRandom, int MaxLevel, class Monoid, bool Recency>
+struct list_layout<skiplist<K, V, Compare, TRandom, MaxLevel, Monoid, Recency>> {
+    typedef SLNode<K, typename std::conditional<std::is_void<Monoid>::value, V, const V>::type, typename skiplist_aggregate<Monoid>::type, Recency> node;
+    static const int levels = MaxLevel;
+};
+
+template<class SL>
+void check_same(const SL& s, const model& ref) {
+    s.check_invariants();
+    CHECK(s.size() == ref.m.size());
+    CHECK(s.empty() == ref.m.empty());
+    auto mi = ref.m.begin();
+    for(auto it=s.cbegin(); it != s.cend(); ++it, ++mi) {
+        CHECK(mi != ref.m.end());
+        CHECK(*(it->first) == mi->first);
+        CHECK(*(it->second) == mi->second);
+    }
+    CHECK(mi == ref.m.end());
+}
+
+template<class SL>
+void run_skiplist(const uint8_t* data, size_t size, eviction_policy policy, size_t capacity, size_t bytes=0) {
+    // a byte budget needs towers of a single node for the model to know the
+    // node count
+    op_stream in(data, size);
+    double p = 0.25 + (in.next() % 4) * 0.2;
+    SL s(bytes? 0.0 : p);
+    model ref(policy, capacity, bytes, sizeof(typename list_layout<SL>::node), list_layout<SL>::levels - 1);
+    if(policy != NO_EVICTION) s.set_capacity(capacity, bytes, policy);
+    const SL& cs = s;
+
+    while(! in.done()) {
+        // inserts are drawn more often than the rest so that lists fill up
+        uint8_t op = in.next() % 32;
+        if(op >= 21) op = 0;
+        int k = in.key();
+        switch(op) {
+        case 0: {
+            long v = in.value();
+            bool fresh = ! ref.m.count(k);
+            auto r = s.insert(k, v);
+            CHECK(r.second == fresh);
+            CHECK(*(r.first->first) == k);
+            if(fresh) {
+                ref.m[k] = v;
+                ref.added(k);
+            } else {
+                ref.touch(k);
+            }
+            break;
+        }
+        case 1: {
+            // augmented skiplists hand out const references, their writes go
+            // through insert_or_assign
+            static_assert(std::is_const<typename std::remove_reference<decltype(s[k])>::type>::value
+                    == ! std::is_void<typename SL::aggregate_type>::value, "operator[] on an augmented skiplist must be read only");
+            long v = in.value();
+            if(ref.m.count(k)) {
+                CHECK(s[k] == ref.m[k]);
+                ref.touch(k);
+            } else {
+                CHECK(s[k] == 0);
+                ref.m[k] = 0;
+                ref.added(k);
+            }
+            if constexpr (std::is_void<typename SL::aggregate_type>::value) {
+                s[k] = v;
+                ref.m[k] = v;
+            }
+            break;
+        }
+        case 2: {
+            long v = in.value();
+            bool fresh = ! ref.m.count(k);
+            CHECK(s.insert_or_assign(k, v).second == fresh);
+            ref.m[k] = v;
+            if(fresh) ref.added(k);
+            else ref.touch(k);
+            break;
+        }
+        case 3:
+            CHECK(s.erase(k) == ref.m.count(k));
+            ref.removed(k);
+            break;
+        case 4:
+            s.erase(s.find(k));
+            ref.removed(k);
+            break;
+        case 5: {
+            int k2 = k + in.next() % 8;
+            s.erase(s.lower_bound(k), s.lower_bound(k2));
+            std::vector<int> gone;
+            for(auto mi=ref.m.lower_bound(k); mi != ref.m.lower_bound(k2); ++mi) {
+                gone.push_back(mi->first);
+            }
+            for(int g: gone) {
+                ref.removed(g);
+            }
+            break;
+        }
+        case 6: {
+            auto ci = cs.find(k);
+            CHECK((ci != cs.cend()) == (ref.m.count(k) == 1));
+            auto it = s.find(k);
+            CHECK((it != s.end()) == (ref.m.count(k) == 1));
+            if(it != s.end()) CHECK(*(it->second) == ref.m[k]);
+            ref.touch(k);
+            break;
+        }
+        case 7:
+            CHECK(s.exists(k) == (ref.m.count(k) == 1));
+            CHECK(s.count(k) == ref.m.count(k));
+            break;
+        case 8: {
+            auto lb = ref.m.lower_bound(k), ub = ref.m.upper_bound(k);
+            auto slb = s.lower_bound(k), sub = s.upper_bound(k);
+            auto clb = cs.lower_bound(k), cub = cs.upper_bound(k);
+            CHECK((slb == s.end()) == (lb == ref.m.end()) && (clb == cs.cend()) == (lb == ref.m.end()));
+            CHECK((sub == s.end()) == (ub == ref.m.end()) && (cub == cs.cend()) == (ub == ref.m.end()));
+            if(lb != ref.m.end()) CHECK(*(slb->first) == lb->first && *(clb->first) == lb->first);
+            if(ub != ref.m.end()) CHECK(*(sub->first) == ub->first && *(cub->first) == ub->first);
+            break;
+        }
+        case 9:
+            if(ref.m.count(k)) {
+                CHECK(cs.at(k) == ref.m[k]);
+                CHECK(s.at(k) == ref.m[k]);
+                ref.touch(k);
+            } else {
+                CHECK_THROWS(cs.at(k), SLNodeException);
+                CHECK_THROWS(s.at(k), SLNodeException);
+            }
+            break;
+        case 10:
+            if(ref.m.empty()) {
+                CHECK_THROWS(s.front(), SkiplistException);
+                CHECK_THROWS(s.back(), SkiplistException);
+            } else {
+                CHECK(s.front() == ref.m.begin()->first);
+                CHECK(s.back() == ref.m.rbegin()->first);
+            }
+            break;
+        case 11:
+            if(ref.m.empty()) {
+                CHECK_THROWS(s.pop_front(), SkiplistException);
+            } else {
+                s.pop_front();
+                ref.removed(ref.m.begin()->first);
+            }
+            break;
+        case 12:
+            if(ref.m.empty()) {
+                CHECK_THROWS(s.pop_back(), SkiplistException);
+            } else {
+                s.pop_back();
+                ref.removed(ref.m.rbegin()->first);
+            }
+            break;
+        case 13: {
+            // find refreshes k, then update_key makes the node it returns,
+            // which holds k2 either way, the most recent one
+            // the node is relinked, never reallocated, wherever it moves
+            // from or to: the front and a new minimum are made frequent
+            int k2 = in.key();
+            uint8_t shape = in.next() % 4;
+            if(shape == 1 && ! ref.m.empty()) k = ref.m.begin()->first;
+            if(shape == 2 && ! ref.m.empty()) k2 = ref.m.begin()->first - 1 - (k2 + 40) % 3;
+            if(! ref.m.count(k)) {
+                CHECK_THROWS(s.update_key(s.end(), k2), SkiplistException);
+                break;
+            }
+            auto it = s.find(k);
+            auto before = *it;
+            auto r = s.update_key(it, k2);
+            ref.touch(k);
+            CHECK(*(r.first->first) == k2);
+            if(r.second) CHECK(r.first->first == before.first && r.first->second == before.second);
+            CHECK(r.second == (k == k2 || ! ref.m.count(k2)));
+            if(r.second && k != k2) {
+                long v = ref.m[k];
+                ref.removed(k);
+                ref.m[k2] = v;
+            }
+            ref.touch(k2);
+            break;
+        }
+        case 14: {
+            auto mi = ref.m.begin();
+            for(auto it=s.begin(); it != s.end(); it++, ++mi) {
+                CHECK(*(it->first) == mi->first);
+            }
+            auto ri = ref.m.rbegin();
+            if(! s.empty()) {
+                auto it = s.end();
+                do {
+                    --it;
+                    CHECK(*(it->first) == ri->first);
+                    ++ri;
+                } while(it != s.begin());
+            }
+            CHECK(ri == ref.m.rend());
+            auto cit = cs.cend();
+            if(! s.empty()) {
+                cit--;
+                CHECK(*(cit->first) == ref.m.rbegin()->first);
+            }
+            break;
+        }
+        case 15: {
+            SL copy(s);
+            check_same(copy, ref);
+            SL other;
+            other = copy;
+            other = other;
+            check_same(other, ref);
+            other.swap(copy);
+            check_same(copy, ref);
+            s.swap(other);
+            s.swap(other);
+            break;
+        }
+        case 16:
+            if(in.next() < 16) {
+                s.clear();
+                ref.m.clear();
+                ref.recency.clear();
+            }
+            break;
+        case 17: {
+            int k2 = in.key();
+            unsigned int threads = 1 + in.next() % 3;
+            long expected = 0;
+            for(auto mi=ref.m.lower_bound(k); mi != ref.m.end() && mi->first < k2; ++mi) {
+                expected += mi->second;
+            }
+            if(k2 <= k) expected = 0;
+            auto acc = [](long a, const typename SL::value_type& kv) { return a + *(kv.second); };
+            auto add = [](long a, long b) { return a + b; };
+            CHECK(s.parallel_reduce(k, k2, 0L, acc, add, threads) == expected);
+            std::atomic<long> sum(0);
+            s.parallel_for_each(k, k2, [&sum](const typename SL::value_type& kv) { sum += *(kv.second); }, threads);
+            CHECK(sum == expected);
+
+            long total = 0;
+            for(auto& kv: ref.m) {
+                total += kv.second;
+            }
+            CHECK(s.parallel_reduce(0L, acc, add, threads) == total);
+            break;
+        }
+        case 18: {
+            int k2 = in.key();
+            unsigned int distance = in.next() % 5;
+            auto mi = (k <= k2)? ref.m.lower_bound(k) : ref.m.end();
+            for(auto kv: s.range(k, k2, distance)) {
+                CHECK(mi != ref.m.end() && kv.first == mi->first && kv.second == mi->second);
+                ++mi;
+            }
+            CHECK(mi == ((k <= k2)? ref.m.upper_bound(k2) : ref.m.end()));
+
+#if __cplusplus >= 202002L
+            // the views compose with the standard adaptors
+            static_assert(std::ranges::view<decltype(s.range(k, k2))>);
+            static_assert(std::ranges::view<decltype(cs.range(k, k2))>);
+            auto even = [](const auto& kv) { return kv.second % 2 == 0; };
+            std::vector<std::pair<int, long>> expected;
+            for(mi = ref.m.lower_bound(k); k <= k2 && mi != ref.m.upper_bound(k2) && expected.size() < 3; ++mi) {
+                if(even(*mi)) expected.push_back(*mi);
+            }
+            auto ei = expected.begin();
+            for(auto kv: cs.range(k, k2, distance) | std::views::filter(even) | std::views::take(3)) {
+                CHECK(ei != expected.end() && kv.first == ei->first && kv.second == ei->second);
+                ++ei;
+            }
+            CHECK(ei == expected.end());
+#endif
+
+            mi = ref.m.lower_bound(k);
+            for(auto c=cs.cursor_at(k, distance); c.valid(); c.next(), ++mi) {
+                CHECK(mi != ref.m.end() && c.key() == mi->first && c.value() == mi->second);
+            }
+            CHECK(mi == ref.m.end());
+            break;
+        }
+        case 19:
+            if constexpr (! std::is_void<typename SL::aggregate_type>::value) {
+                int k2 = in.key();
+                typename SL::aggregate_type expected = 0, total = 0;
+                for(auto& kv: ref.m) {
+                    if(k <= kv.first && kv.first < k2) expected += kv.second;
+                    total += kv.second;
+                }
+                CHECK(s.aggregate(k, k2) == expected);
+                CHECK(s.aggregate() == total);
+            }
+            break;
+        case 20: {
+            // split at k, then join the halves back, either appending the
+            // tail or appending both to an empty list
+            SL tail;
+            if(policy != NO_EVICTION) {
+                CHECK_THROWS(s.split(k, tail), SkiplistException);
+                break;
+            }
+            s.split(k, tail);
+            model lo(NO_EVICTION, 0), hi(NO_EVICTION, 0);
+            for(auto& kv: ref.m) {
+                (kv.first < k ? lo : hi).m.insert(kv);
+            }
+            check_same(s, lo);
+            check_same(tail, hi);
+            if(! s.empty() && ! tail.empty()) CHECK_THROWS(tail.append(s), SkiplistException);
+            if(in.next() % 2) {
+                s.append(tail);
+            } else {
+                SL joined;
+                joined.append(s);
+                joined.append(tail);
+                CHECK(s.empty());
+                s.swap(joined);
+            }
+            CHECK(tail.empty());
+            tail.check_invariants();
+            break;
+        }
+        }
+        check_same(s, ref);
+        if(bytes) CHECK(s.memory_usage() == ref.usage());
+    }
+}
+
+
+template<class CS, class Key>
+void run_compressed(const uint8_t* data, size_t size, Key make_key) {
+    op_stream in(data, size);
+    CS s(0.25 + (in.next() % 4) * 0.2);
+    std::map<decltype(make_key(0)), long> ref;
+
+    while(! in.done()) {
+        uint8_t op = in.next() % 6;
+        auto k = make_key(in.key());
+        switch(op) {
+        case 0: {
+            long v = in.value();
+            CHECK(s.insert(k, v) == ref.insert({k, v}).second);
+            break;
+        }
+        case 1:
+            CHECK(s.erase(k) == ref.erase(k));
+            break;
+        case 2: {
+            long v = in.value();
+            s[k] = v;
+            ref[k] = v;
+            break;
+        }
+        case 3:
+            CHECK(s.exists(k) == (ref.count(k) == 1));
+            if(ref.count(k)) CHECK(s.at(k) == ref[k] && (*s.find(k)).second == ref[k]);
+            else CHECK_THROWS(s.at(k), SkiplistException);
+            break;
+        case 4: {
+            auto it = s.lower_bound(k);
+            auto mi = ref.lower_bound(k);
+            for(; mi != ref.end(); ++it, ++mi) {
+                CHECK(it != s.end() && (*it).first == mi->first && (*it).second == mi->second);
+            }
+            CHECK(it == s.end());
+            break;
+        }
+        case 5: {
+            CS copy(s);
+            s = copy;
+            break;
+        }
+        }
+        CHECK(s.size() == ref.size());
+        auto mi = ref.begin();
+        for(auto it=s.cbegin(); it != s.cend(); ++it, ++mi) {
+            CHECK(mi != ref.end() && (*it).first == mi->first && (*it).second == mi->second);
+        }
+        CHECK(mi == ref.end());
+        if(! ref.empty()) CHECK(s.front() == ref.begin()->first);
+    }
+}
+
+
+template<class SH>
+void run_sharded(const uint8_t* data, size_t size) {
+    op_stream in(data, size);
+    SH s(2 + in.next() % 3);
+    s.set_rebalance(1.5, 8);
+    std::map<int, long> ref;
+
+    while(! in.done()) {
+        uint8_t op = in.next() % 6;
+        int k = in.key();
+        switch(op) {
+        case 0: {
+            long v = in.value();
+            CHECK(s.insert(k, v) == ref.insert({k, v}).second);
+            break;
+        }
+        case 1:
+            CHECK(s.erase(k) == ref.erase(k));
+            break;
+        case 2: {
+            long v = -1;
+            CHECK(s.find(k, v) == (ref.count(k) == 1));
+            CHECK(s.exists(k) == (ref.count(k) == 1));
+            if(ref.count(k)) CHECK(v == ref[k]);
+            break;
+        }
+        case 3: {
+            int k2 = in.key();
+            auto mi = ref.lower_bound(k);
+            s.for_each(k, k2, [&](const int& key, const long& v) {
+                CHECK(mi != ref.end() && key == mi->first && v == mi->second);
+                ++mi;
+            });
+            CHECK(k2 <= k || mi == ref.lower_bound(k2));
+            break;
+        }
+        case 4:
+            s.rebalance();
+            break;
+        case 5: {
+            // a run of ascending keys past the largest one, which always
+            // lands in the last shard in use
+            int n = 1 + in.next() % 32;
+            k = ref.empty() ? 0 : ref.rbegin()->first + 1;
+            for(int j=0; j < n; j++, k++) {
+                CHECK(s.insert(k, j));
+                ref[k] = j;
+            }
+            break;
+        }
+        }
+        CHECK(s.size() == ref.size());
+        auto sizes = s.shard_sizes();
+        CHECK(std::accumulate(sizes.begin(), sizes.end(), size_t(0)) == ref.size());
+        auto mi = ref.begin();
+        s.for_each([&](const int& key, const long& v) {
+            CHECK(mi != ref.end() && key == mi->first && v == mi->second);
+            ++mi;
+        });
+        CHECK(mi == ref.end());
+    }
+}
+
+
+inline void run_all(const uint8_t* data, size_t size) {
+    typedef skiplist<int, long, std::less<int>, replay_engine> plain_list;
+    typedef augmented_skiplist<int, long, sum_monoid<long>, std::less<int>, replay_engine, 5> sum_list;
+    typedef lru_skiplist<int, long, std::less<int>, replay_engine, 10, sum_monoid<long>> lru_list;
+
+    replay_engine::seed() = 0;
+    run_skiplist<plain_list>(data, size, NO_EVICTION, 0);
+    run_skiplist<sum_list>(data, size, NO_EVICTION, 0);
+    run_skiplist<lru_list>(data, size, EVICT_LRU, 20);
+    run_skiplist<plain_list>(data, size, EVICT_SMALLEST, 12);
+    run_skiplist<sum_list>(data, size, EVICT_LARGEST, 12);
+    run_skiplist<plain_list>(data, size, EVICT_LARGEST, 0, 800);
+    run_skiplist<lru_list>(data, size, EVICT_LRU, 16, 1600);
+    run_skiplist<sum_list>(data, size, EVICT_SMALLEST, 0, 1);
+
+    run_compressed<compressed_skiplist<std::string, long, front_codec, std::less<std::string>, replay_engine>>(data, size,
+        [](int k) { return "https://example.com/tenant/" + std::to_string(k / 10) + "/item/" + std::to_string(k); });
+    run_compressed<compressed_skiplist<unsigned int, long, delta_codec<unsigned int, unsigned char>, std::less<unsigned int>, replay_engine>>(data, size,
+        [](int k) { return static_cast<unsigned int>(k + 40) * 37; });
+
+    // few signed keys spread from INT_MIN to INT_MAX, so that neighbours are
+    // often far apart: gaps go from 1 to the whole range of int, which
+    // unsigned short cannot hold and unsigned int just can
+    auto signed_key = [](int k) {
+        const int keys[] = { std::numeric_limits<int>::min(), std::numeric_limits<int>::min() + 1, -70000, -1, 0, 3, 70000,
+                std::numeric_limits<int>::max() - 1, std::numeric_limits<int>::max() };
+        return keys[(k + 40) % 9];
+    };
+    run_compressed<compressed_skiplist<int, long, delta_codec<int, unsigned short>, std::less<int>, replay_engine>>(data, size, signed_key);
+    run_compressed<compressed_skiplist<int, long, delta_codec<int, unsigned int>, std::less<int>, replay_engine>>(data, size, signed_key);
+    run_compressed<compressed_skiplist<int, long, delta_codec<int, unsigned long long>, std::less<int>, replay_engine>>(data, size, signed_key);
+    run_sharded<sharded_skiplist<int, long, std::less<int>, replay_engine>>(data, size);
+
+    // nodes without recency links cannot evict with EVICT_LRU, and do not
+    // default to it
+    plain_list plain;
+    CHECK_THROWS(plain.set_capacity(1, 0, EVICT_LRU), SkiplistException);
+    plain.set_capacity(1);
+    CHECK(plain.get_eviction_policy() == EVICT_SMALLEST);
+    lru_list lru;
+    lru.set_capacity(1);
+    CHECK(lru.get_eviction_policy() == EVICT_LRU);
+}
+
+#endif // SKIPLIST_DIFFERENTIAL_H
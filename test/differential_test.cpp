@@ -0,0 +1,38 @@
+// Randomized differential test: every container of src/ against std::map on
+// inputs drawn from a seeded generator. The first argument overrides the
+// number of inputs, the second the first seed, so that a failure reported as
+// "seed N" is reproduced by running with "1 N".
+
+#include <iostream>
+#include <random>
+#include <vector>
+#include <csignal>
+#include "differential.hpp"
+
+static volatile unsigned long current_seed = 0;
+
+// failed checks and uncaught exceptions both end in abort
+extern "C" void report_seed(int) {
+    std::fprintf(stderr, "failed on seed %lu\n", current_seed);
+    std::signal(SIGABRT, SIG_DFL);
+}
+
+int main(int argc, char* argv[]) {
+    unsigned long runs = (argc > 1)? std::stoul(argv[1]) : 300;
+    unsigned long first = (argc > 2)? std::stoul(argv[2]) : 1;
+    std::signal(SIGABRT, report_seed);
+
+    size_t ops = 0;
+    for(unsigned long seed=first; seed < first + runs; seed++) {
+        std::mt19937 gen(seed);
+        std::vector<uint8_t> input(1 + gen() % 2048);
+        for(auto& b: input) {
+            b = static_cast<uint8_t>(gen());
+        }
+        current_seed = seed;
+        run_all(input.data(), input.size());
+        ops += input.size();
+    }
+    std::cout << runs << " inputs, " << ops << " bytes of operations: OK" << std::endl;
+    return 0;
+}
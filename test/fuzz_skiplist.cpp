@@ -0,0 +1,30 @@
+// libFuzzer entry point for the differential harness:
+//   make fuzz && ./fuzz_skiplist corpus/
+// Without clang, build with -DSKIPLIST_FUZZ_REPLAY to get a driver that
+// replays the files given on the command line.
+
+#include <cstdint>
+#include <cstddef>
+#include "differential.hpp"
+
+extern "C" int LLVMFuzzerTestOneInput(const uint8_t* data, size_t size) {
+    run_all(data, size);
+    return 0;
+}
+
+#ifdef SKIPLIST_FUZZ_REPLAY
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <vector>
+
+int main(int argc, char* argv[]) {
+    for(int i=1; i < argc; i++) {
+        std::ifstream in(argv[i], std::ios::binary);
+        std::vector<uint8_t> input((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+        LLVMFuzzerTestOneInput(input.data(), input.size());
+        std::cout << argv[i] << ": OK" << std::endl;
+    }
+    return 0;
+}
+#endif
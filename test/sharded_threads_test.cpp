@@ -0,0 +1,96 @@
+// Concurrent test of sharded_skiplist: writer threads insert and erase on
+// disjoint key sets, each against its own std::map, while reader threads
+// walk the shards and look keys up. Ascending runs keep the last shard
+// overfull, so that rebalancing runs under contention. Built with
+// -fsanitize=thread by "make test-thread". The first argument overrides the
+// number of operations per writer.
+
+#include <map>
+#include <random>
+#include <thread>
+#include <vector>
+#include "differential.hpp"
+
+int main(int argc, char* argv[]) {
+    const int writers = 8, readers = 2;
+    int ops = (argc > 1)? std::stoi(argv[1]) : 20000;
+
+    sharded_skiplist<int, long> s(8);
+    s.set_rebalance(1.5, 64);
+    std::vector<std::map<int, long>> refs(writers);
+    std::atomic<bool> done(false);
+
+    std::vector<std::thread> threads;
+    for(int w=0; w < writers; w++) {
+        threads.emplace_back([&, w]() {
+            // writer w owns the keys equal to w modulo writers
+            std::mt19937 gen(w + 1);
+            std::map<int, long>& ref = refs[w];
+            int next = w;
+            for(int i=0; i < ops; i++) {
+                int k;
+                if(gen() % 2) {
+                    k = next;
+                    next += writers;
+                } else {
+                    k = static_cast<int>(gen() % (ops * writers)) / writers * writers + w;
+                }
+                if(gen() % 4) {
+                    long v = i;
+                    CHECK(s.insert(k, v) == ref.insert({k, v}).second);
+                } else {
+                    CHECK(s.erase(k) == ref.erase(k));
+                }
+                long v = -1;
+                CHECK(s.find(k, v) == (ref.count(k) == 1));
+                if(ref.count(k)) CHECK(v == ref[k]);
+            }
+        });
+    }
+    for(int r=0; r < readers; r++) {
+        threads.emplace_back([&, r]() {
+            std::mt19937 gen(writers + r + 1);
+            while(! done) {
+                bool first = true;
+                int previous = 0;
+                s.for_each([&](const int& key, const long&) {
+                    CHECK(first || previous < key);
+                    first = false;
+                    previous = key;
+                });
+                int lo = static_cast<int>(gen() % (ops * writers));
+                s.for_each(lo, lo + 64, [&](const int& key, const long&) {
+                    CHECK(lo <= key && key < lo + 64);
+                });
+                if(r == 0 && gen() % 8 == 0) s.rebalance();
+            }
+        });
+    }
+    for(int w=0; w < writers; w++) {
+        threads[w].join();
+    }
+    done = true;
+    for(int r=0; r < readers; r++) {
+        threads[writers + r].join();
+    }
+
+    std::map<int, long> all;
+    for(auto& ref: refs) {
+        all.insert(ref.begin(), ref.end());
+    }
+    CHECK(s.size() == all.size());
+    auto mi = all.begin();
+    s.for_each([&](const int& key, const long& v) {
+        CHECK(mi != all.end() && key == mi->first && v == mi->second);
+        ++mi;
+    });
+    CHECK(mi == all.end());
+
+    auto sizes = s.shard_sizes();
+    std::printf("%d writers, %d operations each, %zu keys, shards:", writers, ops, all.size());
+    for(size_t n: sizes) {
+        std::printf(" %zu", n);
+    }
+    std::printf(": OK\n");
+    return 0;
+}